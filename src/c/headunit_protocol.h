@@ -13,6 +13,24 @@
 #define HU_PROTOCOL_MAGIC 0xA5
 #define HU_PROTOCOL_VERSION 0x02
 #define HU_MAX_PAYLOAD_SIZE 230
+#define HU_FRAME_HEADER_SIZE 9
+#define HU_FRAME_CRC_SIZE 2 // Optional trailer, present if HU_FLAG_CRC
+#define HU_MAX_FRAME_SIZE (HU_FRAME_HEADER_SIZE + HU_MAX_PAYLOAD_SIZE + HU_FRAME_CRC_SIZE)
+
+// Header flags
+#define HU_FLAG_NEED_ACK 0x01 // Receiver answers with HU_MSG_ACK
+#define HU_FLAG_WINDOWED 0x02 // seq_num belongs to a per-link reliable stream (hu_reliable.h)
+#define HU_FLAG_SYN 0x04      // First window of a reliable stream (restarted at seq 0)
+#define HU_FLAG_CRC 0x08      // CRC-16 trailer follows the payload (hu_crc.h)
+#define HU_FLAG_EPOCH_MASK 0x30 // WINDOWED: stream epoch, changes on every sender restart
+#define HU_FLAG_EPOCH_SHIFT 4
+
+// Compile-time layout checks (usable from C11 and C++)
+#ifdef __cplusplus
+#define HU_STATIC_ASSERT(cond, msg) static_assert(cond, msg)
+#else
+#define HU_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
+#endif
 
 // === 2. ADDRESSING & TYPES ===
 
@@ -23,11 +41,18 @@ typedef enum
   HU_ADDR_BROADCAST = 0xFF,   // To All
   HU_ADDR_UNASSIGNED = 0xFE,  // Default for new devices
 
-  // Dynamic Range: 0x10 ... 0xFD
+  // Dynamic Range: 0x10 ... 0xF0
   HU_ADDR_MIN_DYNAMIC = 0x10,
-  HU_ADDR_MAX_DYNAMIC = 0xFD
+  HU_ADDR_MAX_DYNAMIC = 0xF0,
+
+  // Group Range: 0xF1 ... 0xFD (membership set by SYS_GROUP_SET)
+  HU_ADDR_MIN_GROUP = 0xF1,
+  HU_ADDR_MAX_GROUP = 0xFD
 } hu_device_address_t;
 
+#define HU_GROUP_COUNT (HU_ADDR_MAX_GROUP - HU_ADDR_MIN_GROUP + 1)
+#define HU_GROUP_BIT(addr) ((uint16_t)(1u << ((addr) - HU_ADDR_MIN_GROUP)))
+
 // Device Types (Firmware Class)
 typedef enum
 {
@@ -56,31 +81,54 @@ typedef enum
   HU_MSG_PING = 0x01,
   HU_MSG_ACK = 0x02,
   HU_MSG_ERROR = 0x03,
+  HU_MSG_BATCH = 0x04, // Container: several sub-messages in one frame
 
   // Discovery & Config
   HU_MSG_SYS_DISCOVERY_REQ = 0x05, // RPi -> Broadcast
   HU_MSG_SYS_DISCOVERY_RES = 0x06, // Node -> RPi
   HU_MSG_SYS_ASSIGN_ID = 0x07,     // RPi -> Node
   HU_MSG_SYS_REBOOT = 0x08,
+  HU_MSG_SYS_ROUTE_UPDATE = 0x09, // RPi -> Node: sparse routing table / delta
+  HU_MSG_SYS_RSSI_SURVEY = 0x0A,  // RPi -> Broadcast: self-timed roll call
+  HU_MSG_SYS_RSSI_REPORT = 0x0B,  // Node -> RPi: RSSI of every roll-call ping heard
+  HU_MSG_SYS_TIME_SYNC = 0x0C,    // Network time: probe / echo / follow-up
+  HU_MSG_SYS_GROUP_SET = 0x0D,    // RPi -> Node(s): group address membership
+  HU_MSG_SYS_STATS_REQ = 0x0E,    // RPi -> Node: pull DATA_STATS
 
   // --- Control (RPi -> Node) ---
   HU_MSG_CMD_SET_STATE = 0x10,
   HU_MSG_CMD_PROFILE_LOAD = 0x11, // Load full profile chunk
   HU_MSG_CMD_HAPTIC_CFG = 0x12,
-  HU_MSG_CMD_UI_WIDGET = 0x13,
-  HU_MSG_CMD_UI_MENU = 0x14,
+  HU_MSG_CMD_UI_WIDGET = 0x13, // Widget definition, cached on the node (hu_widget.h)
+  HU_MSG_CMD_UI_MENU = 0x14, // Menu bounds for on-node hit-testing (hu_knob.h)
+  HU_MSG_CMD_PROFILE_CHUNK = 0x15,    // Part of a profile larger than one frame
+  HU_MSG_CMD_PROFILE_ACTIVATE = 0x16, // Run a profile from the node cache
+  HU_MSG_CMD_TELEMETRY_CFG = 0x17,    // Per-channel rate / aggregation / report-on-delta
+  HU_MSG_CMD_OTA_BEGIN = 0x18,        // Multicast firmware image announce (hu_ota.h)
+  HU_MSG_CMD_OTA_CHUNK = 0x19,        // One numbered piece of the image
+  HU_MSG_CMD_OTA_STATUS_REQ = 0x1A,   // Slotted poll for missing-chunk bitmaps
+  HU_MSG_CMD_OTA_CTRL = 0x1B,         // Apply / commit / rollback / abort
+  HU_MSG_CMD_UI_UPDATE = 0x1C,        // Changed fields of cached widgets, several per frame
 
   // --- Events (Node -> RPi) ---
   HU_MSG_EVENT_UI_INPUT = 0x20,
   HU_MSG_EVENT_CRITICAL = 0x21,
   HU_MSG_EVENT_FLOW_START = 0x22, // First drop
+  HU_MSG_EVENT_OTA_STATUS = 0x23, // Node -> RPi: OTA state + missing-chunk bitmap
+  HU_MSG_EVENT_UI_ROTATE = 0x24,  // Coalesced knob rotation (replaces per-step INPUT_ROTATE)
 
   // --- Telemetry (Node -> RPi) ---
   HU_MSG_DATA_SENSOR = 0x30,
   HU_MSG_DATA_MULTI = 0x31,
-  HU_MSG_DATA_SCALE = 0x32
+  HU_MSG_DATA_SCALE = 0x32,
+  HU_MSG_DATA_BLOCK = 0x33,    // Delta-encoded block of DATA_SCALE / DATA_MULTI samples
+  HU_MSG_DATA_AGGREGATE = 0x34, // Min / max / mean / last of one aggregation window
+  HU_MSG_DATA_STATS = 0x35      // Node -> RPi: link / hot-path counters and latency histograms
 } hu_msg_type_t;
 
+// Highest hu_msg_type_t: sizes the dispatch table, move it with the enum
+#define HU_MSG_TYPE_LAST HU_MSG_DATA_STATS
+
 // === 4. ENUMS & FLAGS ===
 
 typedef enum
@@ -117,6 +165,28 @@ typedef enum
   INPUT_TOUCH = 5
 } hu_input_event_t;
 
+typedef enum
+{
+  HU_WIDGET_NONE = 0,  // Removes the widget
+  HU_WIDGET_LABEL = 1, // Static text
+  HU_WIDGET_VALUE = 2, // Numeric readout: value / 10^decimals + label as unit
+  HU_WIDGET_GAUGE = 3, // Arc from min to max
+  HU_WIDGET_BAR = 4,   // Horizontal bar from min to max
+  HU_WIDGET_ICON = 5   // value = icon index
+} hu_widget_kind_t;
+
+// HU_MSG_ERROR codes
+typedef enum
+{
+  HU_ERR_UNKNOWN = 0x00,
+  HU_ERR_BAD_PAYLOAD = 0x01,        // Size / range check failed
+  HU_ERR_PROFILE_NOT_CACHED = 0x02, // CMD_PROFILE_ACTIVATE miss: send the profile
+  HU_ERR_BUSY = 0x03,               // Cannot execute now (e.g. shot running)
+  HU_ERR_ROUTE_GENERATION = 0x04,   // Route delta base mismatch: send a full table
+  HU_ERR_OTA_STATE = 0x05,          // CMD_OTA_CTRL not valid in the current OTA state
+  HU_ERR_WIDGET_NOT_CACHED = 0x06   // CMD_UI_UPDATE for an undefined widget: send CMD_UI_WIDGET
+} hu_error_code_t;
+
 #pragma pack(push, 1)
 
 // === 5. FRAME STRUCTURES ===
@@ -125,7 +195,7 @@ typedef enum
 typedef struct
 {
   uint8_t magic;    // 0xA5
-  uint8_t flags;    // 0x01=NEED_ACK
+  uint8_t flags;    // HU_FLAG_*
   uint8_t src_id;   // hu_device_address_t
   uint8_t dst_id;   // hu_device_address_t
   uint8_t via_id;   // 0 = Direct
@@ -136,7 +206,175 @@ typedef struct
 
 // --- PAYLOADS ---
 
-// Discovery Response
+// ACK (cumulative + selective)
+// Stop-and-wait: ack_seq = seq_num + 1, sack_bits = 0
+typedef struct
+{
+  uint16_t ack_seq;   // Next expected seq: everything before it received
+  uint32_t sack_bits; // Bit N: (ack_seq + 1 + N) received out of order
+} hu_payload_ack_t;
+
+// Error
+typedef struct
+{
+  uint8_t ref_msg_type; // hu_msg_type_t that failed
+  uint8_t code;         // hu_error_code_t
+} hu_payload_error_t;
+
+// Batch record: repeated { msg_type, len, body[len] } up to payload_len.
+// Sub-messages share the outer header (src, dst, seq, flags).
+typedef struct
+{
+  uint8_t msg_type; // hu_msg_type_t (never HU_MSG_BATCH)
+  uint8_t len;
+  // uint8_t body[len];
+} hu_batch_record_t;
+
+// Route Update (sparse table)
+// FULL: every target not listed is direct. DELTA: only listed targets change
+// (next_hop 0 = back to direct), applied only on top of base_generation.
+#define HU_ROUTE_UPDATE_FULL 0x00
+#define HU_ROUTE_UPDATE_DELTA 0x01
+typedef struct
+{
+  uint8_t target;
+  uint8_t next_hop; // 0 = direct
+} hu_route_entry_t;
+
+typedef struct
+{
+  uint16_t generation;      // Table version, newer = larger (mod 2^16)
+  uint16_t base_generation; // DELTA only
+  uint8_t mode;             // HU_ROUTE_UPDATE_*
+  // hu_route_entry_t entries[];
+} hu_payload_route_update_t;
+
+// RSSI Survey (mapping, docs/routing.md)
+// probes[i] sends a broadcast PING at i * slot_ms after the request, then at
+// (probe_count + i) * slot_ms one RSSI_REPORT with everything it heard.
+// Only listed nodes take part: an incremental re-map lists just the
+// endpoints of drifted links.
+#define HU_RSSI_SURVEY_FULL 0x00
+#define HU_RSSI_SURVEY_INCREMENTAL 0x01
+typedef struct
+{
+  uint8_t session; // Echoed in reports
+  uint8_t mode;    // HU_RSSI_SURVEY_* (informational for nodes)
+  uint8_t slot_ms;
+  // uint8_t probes[]; // Logical IDs, slot order
+} hu_payload_rssi_survey_t;
+
+typedef struct
+{
+  uint8_t src_id;  // Pinging node
+  int8_t rssi_dbm; // Mean over samples
+  uint8_t samples; // Frames heard from src_id (0 = not heard)
+} hu_rssi_entry_t;
+
+typedef struct
+{
+  uint8_t session;
+  // hu_rssi_entry_t entries[]; // One per probe except the reporter itself
+} hu_payload_rssi_report_t;
+
+// Group Set
+// device_type HU_TYPE_UNKNOWN: applies to the addressed node(s). Otherwise
+// only nodes of that type apply it, so one broadcast provisions a type group
+// ("all boilers").
+#define HU_GROUP_OP_SET 0x00   // group_mask replaces membership
+#define HU_GROUP_OP_JOIN 0x01  // group_mask is added
+#define HU_GROUP_OP_LEAVE 0x02 // group_mask is removed
+typedef struct
+{
+  uint8_t device_type; // hu_device_type_t filter, HU_TYPE_UNKNOWN = any
+  uint8_t op;          // HU_GROUP_OP_*
+  uint16_t group_mask; // Bit N = address HU_ADDR_MIN_GROUP + N
+} hu_payload_group_set_t;
+
+// Stats (hu_stats.h)
+// Counters are cumulative and wrap: the gateway works with differences.
+// Histograms and link RSSI cover the interval since the last reset
+// (STATS_REQ with HU_STATS_REQ_RESET). Histogram bucket 0 counts 0 ms,
+// bucket k >= 1 counts [2^(k-1), 2^k) ms, the last bucket everything above;
+// counts saturate at 65535.
+#define HU_STATS_REQ_RESET 0x01 // Start a new interval after the snapshot
+#define HU_STATS_HIST_BUCKETS 12
+typedef enum
+{
+  HU_STATS_HIST_FORWARD = 0,  // RX to forward handed to the radio
+  HU_STATS_HIST_TX_QUEUE = 1, // hu_tx_push to hu_tx_next
+  HU_STATS_HIST_ACK_RTT = 2,  // Reliable send to ACK (first transmissions only)
+  HU_STATS_HIST_COUNT = 3
+} hu_stats_hist_id_t;
+
+typedef struct
+{
+  uint8_t flags; // HU_STATS_REQ_*
+} hu_payload_stats_req_t;
+
+typedef struct
+{
+  uint8_t peer_id;     // Previous hop the frames arrived from
+  int8_t rssi_avg_dbm; // Moving average
+  int8_t rssi_min_dbm; // Over the interval
+  uint16_t frames;     // Over the interval, saturating
+} hu_stats_link_t;
+
+typedef struct
+{
+  uint32_t uptime_ms;
+  uint32_t interval_ms;   // Since the last reset
+  uint32_t rx_frames;     // Passed the frame view
+  uint32_t rx_bad;        // Rejected by the frame view (any reason)
+  uint32_t rx_bad_crc;    // Subset of rx_bad
+  uint32_t rx_duplicates; // Dropped by deduplication
+  uint32_t rx_overflow;   // RX ring full
+  uint32_t forwarded;
+  uint32_t forward_failed;
+  uint32_t tx_frames;  // Handed to the radio by the TX scheduler
+  uint32_t tx_retries; // Reliable retransmissions (timeout and fast)
+  uint32_t tx_dropped; // TX scheduler: full lane, oldest dropped, expired
+  uint16_t hist[HU_STATS_HIST_COUNT][HU_STATS_HIST_BUCKETS];
+  // hu_stats_link_t links[];
+} hu_payload_stats_t;
+
+// Time Sync (NTP-style, all times in ms on the sender's clock)
+// PROBE (RPi): t1 = coordinator send time.
+// ECHO (node): t1 copied, t2 = node receive, t3 = node send.
+// FOLLOW_UP (RPi): t1..t3 copied, t4 = coordinator receive of the ECHO.
+// The node then knows offset = ((t2 - t1) + (t3 - t4)) / 2 and the RTT.
+#define HU_TIME_SYNC_PROBE 0x00
+#define HU_TIME_SYNC_ECHO 0x01
+#define HU_TIME_SYNC_FOLLOW_UP 0x02
+typedef struct
+{
+  uint8_t kind; // HU_TIME_SYNC_*
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t t3;
+  uint32_t t4;
+} hu_payload_time_sync_t;
+
+// Discovery Request (slotted, incremental)
+// Each node replies in slot hash(MAC, round) % slot_count, unless its MAC is
+// in seen_filter (Bloom filter, k = 2, seeded by round). Later rounds thus
+// only get replies from nodes not heard yet. The v0.2 request had no
+// payload: it reads as round 0 with an empty filter, spread over 16 x 6 ms
+// slots like the old 0..100 ms random jitter.
+#define HU_DISCOVERY_FILTER_BYTES 32
+#define HU_DISCOVERY_REQ_LEGACY_SIZE 0
+#define HU_DISCOVERY_REQ_LEGACY_SLOTS 16
+#define HU_DISCOVERY_REQ_LEGACY_SLOT_MS 6
+typedef struct
+{
+  uint8_t round;      // Seeds slot and filter hashes
+  uint8_t slot_count; // Reply slots in this round (0 counts as 1)
+  uint8_t slot_ms;    // Slot width
+  uint8_t seen_filter[HU_DISCOVERY_FILTER_BYTES];
+} hu_payload_discovery_req_t;
+
+// Discovery Response (v0.2 nodes send the first 5 bytes, without mac)
+#define HU_DISCOVERY_RES_LEGACY_SIZE 5
 typedef struct
 {
   uint8_t device_type; // hu_device_type_t
@@ -144,6 +382,7 @@ typedef struct
   uint8_t fw_major;
   uint8_t fw_minor;
   uint8_t current_id; // 0xFE if unassigned
+  uint8_t mac[6];     // Station MAC (key for seen_filter and SYS_ASSIGN_ID)
 } hu_payload_discovery_res_t;
 
 // Assign ID
@@ -184,6 +423,11 @@ typedef struct
   uint8_t energy_tol;    // Raw Index
 } hu_profile_node_t;
 
+// config_flags accessors
+#define HU_NODE_INTERPOLATION(cfg) ((hu_interpolation_t)((cfg) & 0x03))
+#define HU_NODE_PRIORITY(cfg) ((hu_profile_priority_t)(((cfg) >> 2) & 0x03))
+#define HU_NODE_CONFIG(interp, prio) ((uint8_t)(((interp) & 0x03) | (((prio) & 0x03) << 2)))
+
 // Profile Load Packet (Max ~17 nodes)
 typedef struct
 {
@@ -192,7 +436,145 @@ typedef struct
   // hu_profile_node_t nodes[];
 } hu_payload_profile_load_t;
 
-// Haptic Config
+// Profile Chunk Packet (up to 17 nodes per chunk, any number of chunks)
+// Chunks may arrive in any order; the node may start executing the profile
+// as soon as the nodes from index 0 onwards are present.
+typedef struct
+{
+  uint8_t profile_id;
+  uint8_t upload_id;   // Sender bumps it for every upload, same for all its chunks
+  uint8_t total_nodes; // Nodes in the whole profile
+  uint8_t first_node;  // Index of nodes[0] within the profile
+  // hu_profile_node_t nodes[];
+} hu_payload_profile_chunk_t;
+
+// Profile Activate (cache hit -> ACK, miss -> ERROR HU_ERR_PROFILE_NOT_CACHED)
+typedef struct
+{
+  uint8_t profile_id;
+  uint8_t total_nodes;
+  uint32_t content_hash; // FNV-1a 32 over the packed nodes[] bytes
+  uint32_t start_at_ms;  // Network time of profile t = 0, 0 = on receipt
+} hu_payload_profile_activate_t;
+
+// Set State (direct actuator control). Sent to several nodes with the same
+// execute_at_ms, all switch on the same network tick.
+typedef struct
+{
+  uint8_t channel;        // Actuator on the node (0 = main)
+  uint8_t state;          // 0 = off, 1 = on, other values device specific
+  uint32_t execute_at_ms; // Network time, 0 = on receipt
+} hu_payload_set_state_t;
+
+// Telemetry Config (hu_telemetry_ctl.h)
+// Subscription for one source / channel on the addressed node(s). Several
+// entries travel in one HU_MSG_BATCH frame; a group address retunes, e.g.,
+// all sensors at shot start and back to idle at shot end.
+//   RAW:       every `decimation`-th sample is reported as usual
+//              (DATA_SCALE / DATA_MULTI / DATA_BLOCK)
+//   AGGREGATE: one DATA_AGGREGATE per window_ms
+//   ON_DELTA:  a sample is reported when |a - last reported a| >=
+//              delta_threshold, or after heartbeat_ms without a report
+// period_ms 0 turns the channel off.
+#define HU_TELEMETRY_MODE_RAW 0x00
+#define HU_TELEMETRY_MODE_AGGREGATE 0x01
+#define HU_TELEMETRY_MODE_ON_DELTA 0x02
+#define HU_TELEMETRY_ALL_CHANNELS 0xFF
+typedef struct
+{
+  uint8_t source_type;     // HU_MSG_DATA_SCALE / HU_MSG_DATA_MULTI / HU_MSG_DATA_SENSOR
+  uint8_t channel;         // Sensor index, HU_TELEMETRY_ALL_CHANNELS = every channel
+  uint8_t mode;            // HU_TELEMETRY_MODE_*
+  uint8_t decimation;      // Report every Nth sample (0 and 1 = every sample)
+  uint16_t period_ms;      // Sampling period, 0 = off
+  uint16_t window_ms;      // AGGREGATE: window length
+  uint16_t heartbeat_ms;   // ON_DELTA: longest silence, 0 = none
+  int32_t delta_threshold; // ON_DELTA: in units of the reported value
+} hu_payload_telemetry_cfg_t;
+
+// OTA (bulk firmware distribution, hu_ota.h)
+// The RPi announces an image with OTA_BEGIN to a type group / broadcast, then
+// sends every chunk once without ACKs. Nodes answer OTA_STATUS_REQ with a
+// bitmap of the chunks they still miss; the RPi resends the union of those
+// and polls again until every node is COMPLETE. OTA_CTRL APPLY reboots into
+// the new image (Pending Verify), COMMIT / ROLLBACK end the update.
+#define HU_OTA_CHUNK_SIZE 224  // Image bytes per CMD_OTA_CHUNK; only the last chunk is shorter
+#define HU_OTA_MAX_CHUNKS 8192 // 1.75 MB image, 1 KB node bitmap
+
+#define HU_OTA_STATE_IDLE 0x00           // No session (or a different one)
+#define HU_OTA_STATE_RECEIVING 0x01      // Partition prepared, chunks missing
+#define HU_OTA_STATE_COMPLETE 0x02       // Every chunk written, image verified
+#define HU_OTA_STATE_FAILED 0x03         // status.error says why
+#define HU_OTA_STATE_PENDING_VERIFY 0x04 // Rebooted into the new image, not committed yet
+
+#define HU_OTA_ERR_NONE 0x00
+#define HU_OTA_ERR_SIZE 0x01    // Image too large / chunk_count does not match image_size
+#define HU_OTA_ERR_PREPARE 0x02 // Partition could not be prepared
+#define HU_OTA_ERR_WRITE 0x03   // Flash write failed
+#define HU_OTA_ERR_VERIFY 0x04  // Image CRC-32 / bootloader check failed
+
+#define HU_OTA_OP_APPLY 0x00    // Boot the new image (at execute_at_ms)
+#define HU_OTA_OP_COMMIT 0x01   // Mark the running image valid
+#define HU_OTA_OP_ROLLBACK 0x02 // Reboot into the previous image
+#define HU_OTA_OP_ABORT 0x03    // Drop the session and its partial image
+
+typedef struct
+{
+  uint8_t session;     // New per image, chosen by the RPi
+  uint8_t device_type; // hu_device_type_t: only these nodes take part
+  uint8_t fw_major;
+  uint8_t fw_minor;
+  uint32_t image_size;  // Bytes
+  uint32_t image_crc32; // CRC-32/ISO-HDLC of the whole image
+  uint16_t chunk_count; // ceil(image_size / HU_OTA_CHUNK_SIZE)
+} hu_payload_ota_begin_t;
+
+typedef struct
+{
+  uint8_t session;
+  uint16_t index; // Chunk number; image offset = index * HU_OTA_CHUNK_SIZE
+  // uint8_t data[];
+} hu_payload_ota_chunk_t;
+
+// probes[i] answers at i * slot_ms after the request; a unicast request
+// with no probes is answered at once.
+typedef struct
+{
+  uint8_t session;
+  uint8_t slot_ms;
+  uint16_t from_chunk; // Report missing chunks from here on
+  // uint8_t probes[]; // Logical IDs, slot order
+} hu_payload_ota_status_req_t;
+
+// bitmap bit i (LSB first) set = chunk base + i missing. base is the first
+// missing chunk at or after from_chunk, trailing zero bytes are dropped.
+// Chunks past the bitmap are not reported: if `missing` counts more than
+// the set bits, the RPi polls again from the end of the bitmap.
+typedef struct
+{
+  uint8_t session;
+  uint8_t state;    // HU_OTA_STATE_*
+  uint8_t error;    // HU_OTA_ERR_* (FAILED)
+  uint16_t missing; // Chunks still missing in the whole image
+  uint16_t base;
+  // uint8_t bitmap[];
+} hu_payload_ota_status_t;
+
+typedef struct
+{
+  uint8_t session;
+  uint8_t op;             // HU_OTA_OP_*
+  uint32_t execute_at_ms; // APPLY: network time of the reboot, 0 = on receipt
+} hu_payload_ota_ctrl_t;
+
+// Haptic Config, executed on the knob (hu_knob.h). Angles in degrees from
+// the knob position at the time the config arrived.
+//   FREE:     no torque
+//   DETENTS:  param_1 = detents per revolution, param_2 = snap: share of
+//             half a detent (%) over which the pull rises to full strength
+//   SPRING:   param_1 = center, param_2 = stiffness (per mille per degree)
+//   BARRIER:  param_1 = min, param_2 = max; free inside, wall outside
+//   SERVO:    as SPRING, the RPi moves param_1 to turn the knob
 typedef struct
 {
   uint8_t mode;     // hu_haptic_mode_t
@@ -201,6 +583,90 @@ typedef struct
   int16_t param_2;  // Snap / Stiffness / Max
 } hu_payload_haptic_cfg_t;
 
+// UI Menu: item bounds for on-node hit-testing in DETENTS mode, one detent
+// per item. Rotation past the first / last item meets a barrier unless
+// HU_MENU_WRAP. item_count 0 removes the menu (free detents).
+#define HU_MENU_WRAP 0x01
+typedef struct
+{
+  uint8_t item_count;
+  uint8_t selected; // Item under the cursor now
+  uint8_t flags;    // HU_MENU_*
+} hu_payload_ui_menu_t;
+
+// UI Widget: full definition, followed by label_len (0..HU_WIDGET_LABEL_MAX)
+// bytes of UTF-8 label / unit, not NUL-terminated. Kind NONE removes it.
+#define HU_WIDGET_MAX 32       // Cached widgets per node, widget_id < HU_WIDGET_MAX
+#define HU_WIDGET_LABEL_MAX 16 // Label bytes
+#define HU_WIDGET_VISIBLE 0x01
+#define HU_WIDGET_HIGHLIGHT 0x02 // Selected / attention
+#define HU_WIDGET_BLINK 0x04
+typedef struct
+{
+  uint8_t widget_id;
+  uint8_t kind;  // hu_widget_kind_t
+  uint8_t x;     // Pixels
+  uint8_t y;
+  uint8_t w;
+  uint8_t h;
+  uint8_t color; // Palette index
+  uint8_t flags; // HU_WIDGET_*
+  uint8_t decimals;
+  int32_t value;
+  int32_t min;
+  int32_t max;
+} hu_payload_ui_widget_t;
+
+// UI Update: count records, each { widget_id, dirty } followed by the fields
+// set in dirty, in bit order:
+//   VALUE   int32        VALUE16 int16 (same field, shorter; not with VALUE)
+//   FLAGS   uint8        COLOR   uint8
+//   RANGE   int32 min, int32 max
+//   RECT    uint8 x, y, w, h
+//   LABEL   uint8 len + len bytes
+// Fields are absolute, so a lost frame heals with the next one. Sent without
+// ACK in the telemetry lane; a readout at 20 Hz costs 4 bytes (VALUE16).
+#define HU_UI_DIRTY_VALUE 0x01
+#define HU_UI_DIRTY_VALUE16 0x02
+#define HU_UI_DIRTY_FLAGS 0x04
+#define HU_UI_DIRTY_COLOR 0x08
+#define HU_UI_DIRTY_RANGE 0x10
+#define HU_UI_DIRTY_RECT 0x20
+#define HU_UI_DIRTY_LABEL 0x40
+typedef struct
+{
+  uint8_t count; // Records
+} hu_payload_ui_update_t;
+
+typedef struct
+{
+  uint8_t widget_id;
+  uint8_t dirty; // HU_UI_DIRTY_*
+} hu_ui_update_record_t;
+
+// UI Rotate: rotation coalesced over one window. A step is one detent in
+// DETENTS mode, one degree otherwise. With a menu an event is sent only
+// when the selected item changes or the knob hits the menu bounds.
+#define HU_ROTATE_MENU 0x01     // position is the selected menu item
+#define HU_ROTATE_AT_LIMIT 0x02 // Pushed against a barrier / menu bound
+typedef struct
+{
+  uint8_t source_index;
+  uint8_t flags;      // HU_ROTATE_*
+  int16_t delta;      // Net steps in the window
+  uint16_t steps;     // Steps in either direction in the window
+  int16_t velocity;   // Net steps per second over the window
+  uint16_t window_ms; // Window length
+  int32_t position;   // Absolute step / menu item after the window
+} hu_payload_event_rotate_t;
+
+// Flow Start (first drop). Like all telemetry timestamps, in network time
+// once the node is synced (hu_timesync.h), otherwise node uptime.
+typedef struct
+{
+  uint32_t timestamp_ms;
+} hu_payload_flow_start_t;
+
 // Scales Telemetry
 typedef struct
 {
@@ -210,6 +676,45 @@ typedef struct
   uint8_t status;
 } hu_payload_scale_data_t;
 
+// Telemetry Block (19 bytes + deltas)
+// Samples at a fixed interval: sample 0 = base values, then for each further
+// sample a zigzag LEB128 varint of (a[k] - a[k-1]) followed, if
+// HU_BLOCK_HAS_B, by one for (b[k] - b[k-1]).
+//   source_type DATA_SCALE: a = weight_mg, b = flow_mg_s
+//   source_type DATA_MULTI: a = value of sensor `channel`
+#define HU_BLOCK_HAS_B 0x01
+typedef struct
+{
+  uint8_t source_type;  // hu_msg_type_t the samples expand to
+  uint8_t channel;      // Sensor index (DATA_MULTI), 0 for scales
+  uint8_t flags;        // HU_BLOCK_*
+  uint8_t sample_count; // Including the base sample
+  uint16_t interval_ms; // Spacing between samples
+  uint32_t base_timestamp_ms;
+  int32_t base_a;
+  int32_t base_b;
+  uint8_t status; // Status of the last sample
+  // uint8_t deltas[];
+} hu_payload_data_block_t;
+
+// Telemetry Aggregate: statistics of `a` over one window (min / max / mean
+// / last), plus the last b and status. For scales a = weight_mg,
+// b = flow_mg_s; for sensors a = value of `channel`.
+typedef struct
+{
+  uint8_t source_type; // hu_msg_type_t the samples came from
+  uint8_t channel;
+  uint16_t count;     // Samples in the window
+  uint32_t start_ms;  // Timestamp of the first sample
+  uint32_t end_ms;    // Timestamp of the last sample
+  int32_t min_a;
+  int32_t max_a;
+  int32_t mean_a;
+  int32_t last_a;
+  int32_t last_b;
+  uint8_t status; // Status of the last sample
+} hu_payload_data_aggregate_t;
+
 // Input Event
 typedef struct
 {
@@ -219,3 +724,46 @@ typedef struct
 } hu_payload_event_input_t;
 
 #pragma pack(pop)
+
+HU_STATIC_ASSERT(sizeof(hu_frame_header_t) == HU_FRAME_HEADER_SIZE, "hu_frame_header_t must be 9 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ack_t) == 6, "hu_payload_ack_t must be 6 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_error_t) == 2, "hu_payload_error_t must be 2 bytes");
+HU_STATIC_ASSERT(sizeof(hu_batch_record_t) == 2, "hu_batch_record_t must be 2 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_route_update_t) == 5, "hu_payload_route_update_t must be 5 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_rssi_survey_t) == 3, "hu_payload_rssi_survey_t must be 3 bytes");
+HU_STATIC_ASSERT(sizeof(hu_rssi_entry_t) == 3, "hu_rssi_entry_t must be 3 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_rssi_report_t) == 1, "hu_payload_rssi_report_t must be 1 byte");
+HU_STATIC_ASSERT(sizeof(hu_payload_discovery_req_t) == 35, "hu_payload_discovery_req_t must be 35 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_discovery_res_t) == 11, "hu_payload_discovery_res_t must be 11 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_assign_id_t) == 7, "hu_payload_assign_id_t must be 7 bytes");
+HU_STATIC_ASSERT(sizeof(hu_profile_node_t) == 13, "hu_profile_node_t must be 13 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_profile_load_t) == 2, "hu_payload_profile_load_t must be 2 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_profile_chunk_t) == 4, "hu_payload_profile_chunk_t must be 4 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_profile_activate_t) == 10, "hu_payload_profile_activate_t must be 10 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_set_state_t) == 6, "hu_payload_set_state_t must be 6 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_flow_start_t) == 4, "hu_payload_flow_start_t must be 4 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_time_sync_t) == 17, "hu_payload_time_sync_t must be 17 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_group_set_t) == 4, "hu_payload_group_set_t must be 4 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_stats_req_t) == 1, "hu_payload_stats_req_t must be 1 byte");
+HU_STATIC_ASSERT(sizeof(hu_stats_link_t) == 5, "hu_stats_link_t must be 5 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_stats_t) == 120, "hu_payload_stats_t must be 120 bytes");
+HU_STATIC_ASSERT(HU_MAX_FRAME_SIZE <= 250, "frame must fit ESP_NOW_MAX_DATA_LEN");
+HU_STATIC_ASSERT(HU_GROUP_COUNT <= 16, "group membership is a uint16_t mask");
+HU_STATIC_ASSERT(sizeof(hu_payload_telemetry_cfg_t) == 14, "hu_payload_telemetry_cfg_t must be 14 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ota_begin_t) == 14, "hu_payload_ota_begin_t must be 14 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ota_chunk_t) == 3, "hu_payload_ota_chunk_t must be 3 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ota_status_req_t) == 4, "hu_payload_ota_status_req_t must be 4 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ota_status_t) == 7, "hu_payload_ota_status_t must be 7 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ota_ctrl_t) == 6, "hu_payload_ota_ctrl_t must be 6 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ota_chunk_t) + HU_OTA_CHUNK_SIZE <= HU_MAX_PAYLOAD_SIZE, "OTA chunk must fit a frame");
+HU_STATIC_ASSERT(HU_OTA_MAX_CHUNKS <= 65536, "chunk index is a uint16_t");
+HU_STATIC_ASSERT(sizeof(hu_payload_haptic_cfg_t) == 6, "hu_payload_haptic_cfg_t must be 6 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ui_menu_t) == 3, "hu_payload_ui_menu_t must be 3 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ui_widget_t) == 21, "hu_payload_ui_widget_t must be 21 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_ui_update_t) == 1, "hu_payload_ui_update_t must be 1 byte");
+HU_STATIC_ASSERT(sizeof(hu_ui_update_record_t) == 2, "hu_ui_update_record_t must be 2 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_event_rotate_t) == 14, "hu_payload_event_rotate_t must be 14 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_scale_data_t) == 11, "hu_payload_scale_data_t must be 11 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_data_block_t) == 19, "hu_payload_data_block_t must be 19 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_data_aggregate_t) == 33, "hu_payload_data_aggregate_t must be 33 bytes");
+HU_STATIC_ASSERT(sizeof(hu_payload_event_input_t) == 6, "hu_payload_event_input_t must be 6 bytes");
@@ -0,0 +1,216 @@
+/**
+ * @file headunit_protocol.hpp
+ * @brief Optional C++17 typed message layer over headunit_protocol.h
+ *
+ * Header-only, no heap. Each hu_msg_type_t with a payload struct is bound to
+ * that struct via hu::msg_traits, so encode()/decode() check payload type and
+ * buffer size at compile time and write straight into the caller's buffer.
+ *
+ *   uint8_t buf[hu::frame_size_v<HU_MSG_DATA_SCALE>];
+ *   size_t n = hu::encode<HU_MSG_DATA_SCALE>(buf, {src, HU_ADDR_COORDINATOR, seq}, sample);
+ *
+ * frame_size_v reserves the CRC trailer; with HU_FLAG_CRC in frame_meta.flags
+ * encode() seals the frame (hu_frame_seal()) and n includes the trailer.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "headunit_protocol.h"
+#include "hu_crc.h"
+#include "hu_discovery.h"
+#include "hu_frame_view.h"
+
+namespace hu
+{
+
+// Header fields supplied by the sender; magic, msg_type and payload_len are
+// filled in by encode().
+struct frame_meta
+{
+  uint8_t src_id;
+  uint8_t dst_id;
+  uint16_t seq_num;
+  uint8_t flags = 0;
+  uint8_t via_id = 0;
+};
+
+// --- Traits: msg_type -> payload struct ---
+
+// Left undefined: messages without a payload struct cannot be encoded typed.
+template <hu_msg_type_t Type>
+struct msg_traits;
+
+#define HU_BIND_PAYLOAD(msg, type)                           \
+  template <>                                                \
+  struct msg_traits<msg>                                     \
+  {                                                          \
+    using payload_type = type;                               \
+    static constexpr std::size_t payload_size = sizeof(type); \
+  }
+
+HU_BIND_PAYLOAD(HU_MSG_ACK, hu_payload_ack_t);
+HU_BIND_PAYLOAD(HU_MSG_ERROR, hu_payload_error_t);
+HU_BIND_PAYLOAD(HU_MSG_SYS_DISCOVERY_REQ, hu_payload_discovery_req_t);
+HU_BIND_PAYLOAD(HU_MSG_SYS_DISCOVERY_RES, hu_payload_discovery_res_t);
+HU_BIND_PAYLOAD(HU_MSG_SYS_ASSIGN_ID, hu_payload_assign_id_t);
+HU_BIND_PAYLOAD(HU_MSG_SYS_TIME_SYNC, hu_payload_time_sync_t);
+HU_BIND_PAYLOAD(HU_MSG_SYS_GROUP_SET, hu_payload_group_set_t);
+HU_BIND_PAYLOAD(HU_MSG_SYS_STATS_REQ, hu_payload_stats_req_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_SET_STATE, hu_payload_set_state_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_HAPTIC_CFG, hu_payload_haptic_cfg_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_UI_MENU, hu_payload_ui_menu_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_PROFILE_ACTIVATE, hu_payload_profile_activate_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_TELEMETRY_CFG, hu_payload_telemetry_cfg_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_OTA_BEGIN, hu_payload_ota_begin_t);
+HU_BIND_PAYLOAD(HU_MSG_CMD_OTA_CTRL, hu_payload_ota_ctrl_t);
+HU_BIND_PAYLOAD(HU_MSG_EVENT_UI_INPUT, hu_payload_event_input_t);
+HU_BIND_PAYLOAD(HU_MSG_EVENT_FLOW_START, hu_payload_flow_start_t);
+HU_BIND_PAYLOAD(HU_MSG_EVENT_UI_ROTATE, hu_payload_event_rotate_t);
+HU_BIND_PAYLOAD(HU_MSG_DATA_SCALE, hu_payload_scale_data_t);
+HU_BIND_PAYLOAD(HU_MSG_DATA_AGGREGATE, hu_payload_data_aggregate_t);
+
+#undef HU_BIND_PAYLOAD
+
+template <hu_msg_type_t Type>
+using payload_t = typename msg_traits<Type>::payload_type;
+
+// Buffer size for one Type frame, room for the optional CRC trailer included
+template <hu_msg_type_t Type>
+inline constexpr std::size_t frame_size_v = HU_FRAME_HEADER_SIZE + msg_traits<Type>::payload_size + HU_FRAME_CRC_SIZE;
+
+// Largest CMD_PROFILE_LOAD that fits one frame
+inline constexpr std::size_t max_profile_nodes =
+    (HU_MAX_PAYLOAD_SIZE - sizeof(hu_payload_profile_load_t)) / sizeof(hu_profile_node_t);
+
+template <std::size_t Nodes>
+inline constexpr std::size_t profile_frame_size_v =
+    HU_FRAME_HEADER_SIZE + sizeof(hu_payload_profile_load_t) + Nodes * sizeof(hu_profile_node_t) + HU_FRAME_CRC_SIZE;
+
+namespace detail
+{
+
+inline void write_header(uint8_t *out, const frame_meta &meta, hu_msg_type_t type, std::size_t payload_len)
+{
+  hu_frame_header_t hdr{};
+  hdr.magic = HU_PROTOCOL_MAGIC;
+  hdr.flags = meta.flags;
+  hdr.src_id = meta.src_id;
+  hdr.dst_id = meta.dst_id;
+  hdr.via_id = meta.via_id;
+  hdr.msg_type = static_cast<uint8_t>(type);
+  hdr.seq_num = meta.seq_num;
+  hdr.payload_len = static_cast<uint8_t>(payload_len);
+  std::memcpy(out, &hdr, sizeof(hdr));
+}
+
+// Frame length, after appending the CRC trailer if meta asks for one
+inline std::size_t finish(uint8_t *out, const frame_meta &meta, std::size_t payload_len)
+{
+  if (meta.flags & HU_FLAG_CRC)
+  {
+    return hu_frame_seal(out);
+  }
+  return HU_FRAME_HEADER_SIZE + payload_len;
+}
+
+template <hu_msg_type_t Type>
+inline std::size_t encode_into(uint8_t *out, const frame_meta &meta, const payload_t<Type> &payload)
+{
+  static_assert(msg_traits<Type>::payload_size <= HU_MAX_PAYLOAD_SIZE, "payload exceeds HU_MAX_PAYLOAD_SIZE");
+  write_header(out, meta, Type, msg_traits<Type>::payload_size);
+  std::memcpy(out + HU_FRAME_HEADER_SIZE, &payload, msg_traits<Type>::payload_size);
+  return finish(out, meta, msg_traits<Type>::payload_size);
+}
+
+} // namespace detail
+
+// --- Encode ---
+
+// Writes header + payload (+ CRC trailer with HU_FLAG_CRC) into buf; returns
+// the frame length.
+template <hu_msg_type_t Type, std::size_t N>
+inline std::size_t encode(uint8_t (&buf)[N], const frame_meta &meta, const payload_t<Type> &payload)
+{
+  static_assert(N >= frame_size_v<Type>, "buffer too small for this message");
+  return detail::encode_into<Type>(buf, meta, payload);
+}
+
+template <hu_msg_type_t Type, std::size_t N>
+inline std::size_t encode(std::array<uint8_t, N> &buf, const frame_meta &meta, const payload_t<Type> &payload)
+{
+  static_assert(N >= frame_size_v<Type>, "buffer too small for this message");
+  return detail::encode_into<Type>(buf.data(), meta, payload);
+}
+
+// CMD_PROFILE_LOAD with a compile-time node count
+template <std::size_t N, std::size_t Nodes>
+inline std::size_t encode_profile_load(uint8_t (&buf)[N], const frame_meta &meta, uint8_t profile_id,
+                                       const hu_profile_node_t (&nodes)[Nodes])
+{
+  static_assert(Nodes <= max_profile_nodes, "too many profile nodes for one frame");
+  static_assert(N >= profile_frame_size_v<Nodes>, "buffer too small for this profile");
+
+  constexpr std::size_t payload_len = sizeof(hu_payload_profile_load_t) + Nodes * sizeof(hu_profile_node_t);
+  detail::write_header(buf, meta, HU_MSG_CMD_PROFILE_LOAD, payload_len);
+
+  hu_payload_profile_load_t head{profile_id, static_cast<uint8_t>(Nodes)};
+  std::memcpy(buf + HU_FRAME_HEADER_SIZE, &head, sizeof(head));
+  std::memcpy(buf + HU_FRAME_HEADER_SIZE + sizeof(head), nodes, Nodes * sizeof(hu_profile_node_t));
+  return detail::finish(buf, meta, payload_len);
+}
+
+// --- Decode (zero-copy) ---
+
+// Messages that v0.2 peers send with a shorter payload (HU_LEN_LEGACY)
+template <hu_msg_type_t Type>
+inline constexpr bool has_legacy_form_v = Type == HU_MSG_SYS_DISCOVERY_REQ || Type == HU_MSG_SYS_DISCOVERY_RES;
+
+// Typed pointer into the view's buffer, nullptr if msg_type or size differ.
+template <hu_msg_type_t Type>
+inline const payload_t<Type> *decode(const hu_frame_view_t &view)
+{
+  static_assert(!has_legacy_form_v<Type>, "may arrive in the v0.2 form: use decode(view, out)");
+  if (hu_frame_view_msg_type(&view) != static_cast<uint8_t>(Type) ||
+      hu_frame_view_payload_len(&view) != msg_traits<Type>::payload_size)
+  {
+    return nullptr;
+  }
+  return reinterpret_cast<const payload_t<Type> *>(hu_frame_view_payload(&view));
+}
+
+// Copy into out; false if msg_type or size differ. Also accepts the v0.2
+// form of SYS_DISCOVERY_REQ / RES (hu_discovery_req_read() / _res_read()).
+template <hu_msg_type_t Type>
+inline bool decode(const hu_frame_view_t &view, payload_t<Type> &out)
+{
+  if (hu_frame_view_msg_type(&view) != static_cast<uint8_t>(Type))
+  {
+    return false;
+  }
+  const uint8_t *payload = hu_frame_view_payload(&view);
+  uint8_t len = hu_frame_view_payload_len(&view);
+  if constexpr (Type == HU_MSG_SYS_DISCOVERY_REQ)
+  {
+    return hu_discovery_req_read(payload, len, &out);
+  }
+  else if constexpr (Type == HU_MSG_SYS_DISCOVERY_RES)
+  {
+    return hu_discovery_res_read(payload, len, &out);
+  }
+  else
+  {
+    if (len != msg_traits<Type>::payload_size)
+    {
+      return false;
+    }
+    std::memcpy(&out, payload, sizeof(out));
+    return true;
+  }
+}
+
+} // namespace hu
@@ -0,0 +1,135 @@
+/**
+ * @file hu_batch.c
+ * @brief Batch container encode / decode
+ */
+
+#include "hu_batch.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// --- Receiver ---
+
+void hu_batch_iter_init(hu_batch_iter_t *it, const hu_frame_view_t *batch)
+{
+  it->pos = hu_frame_view_payload(batch);
+  it->end = it->pos + hu_frame_view_payload_len(batch);
+}
+
+bool hu_batch_next(hu_batch_iter_t *it, uint8_t *msg_type, const uint8_t **body, uint8_t *len)
+{
+  if ((size_t)(it->end - it->pos) < sizeof(hu_batch_record_t))
+  {
+    return false;
+  }
+  uint8_t type = it->pos[0];
+  uint8_t n = it->pos[1];
+  const uint8_t *b = it->pos + sizeof(hu_batch_record_t);
+  if ((size_t)(it->end - b) < n || type == HU_MSG_BATCH || !hu_msg_payload_len_valid(type, n))
+  {
+    it->pos = it->end; // Stop: the rest cannot be trusted
+    return false;
+  }
+
+  *msg_type = type;
+  *body = b;
+  *len = n;
+  it->pos = b + n;
+  return true;
+}
+
+uint8_t hu_dispatch_batch(const hu_dispatcher_t *d, const hu_frame_view_t *batch)
+{
+  uint8_t frame[HU_MAX_FRAME_SIZE];
+  memcpy(frame, batch->data, HU_FRAME_HEADER_SIZE);
+  hu_frame_header_t *hdr = (hu_frame_header_t *)(void *)frame;
+
+  hu_batch_iter_t it;
+  hu_batch_iter_init(&it, batch);
+
+  uint8_t type;
+  const uint8_t *body;
+  uint8_t len;
+  uint8_t dispatched = 0;
+  while (hu_batch_next(&it, &type, &body, &len))
+  {
+    hdr->msg_type = type;
+    hdr->payload_len = len;
+    memcpy(frame + HU_FRAME_HEADER_SIZE, body, len);
+
+    hu_frame_view_t sub = {frame, (uint16_t)(HU_FRAME_HEADER_SIZE + len)};
+    if (hu_dispatch(d, &sub) == HU_DISPATCH_OK)
+    {
+      dispatched++;
+    }
+  }
+  return dispatched;
+}
+
+// --- Sender ---
+
+void hu_batch_tx_init(hu_batch_tx_t *b, uint8_t dst_id, uint16_t deadline_ms, hu_batch_flush_fn flush, void *ctx)
+{
+  memset(b, 0, sizeof(*b));
+  b->dst_id = dst_id;
+  b->deadline_ms = deadline_ms;
+  b->flush = flush;
+  b->ctx = ctx;
+}
+
+void hu_batch_tx_flush(hu_batch_tx_t *b)
+{
+  if (b->count == 0)
+  {
+    return;
+  }
+  if (b->count == 1)
+  {
+    b->flush(b->dst_id, b->buf[0], b->buf + sizeof(hu_batch_record_t), b->buf[1], b->ctx);
+  }
+  else
+  {
+    b->flush(b->dst_id, HU_MSG_BATCH, b->buf, b->len, b->ctx);
+  }
+  b->len = 0;
+  b->count = 0;
+}
+
+bool hu_batch_tx_add(hu_batch_tx_t *b, uint8_t msg_type, const void *body, uint8_t len, uint32_t now_ms)
+{
+  if (msg_type == HU_MSG_BATCH || len > HU_BATCH_MAX_BODY)
+  {
+    return false;
+  }
+
+  size_t need = sizeof(hu_batch_record_t) + len;
+  if (b->len + need > HU_MAX_PAYLOAD_SIZE)
+  {
+    hu_batch_tx_flush(b);
+  }
+  if (b->count == 0)
+  {
+    b->first_ms = now_ms;
+  }
+
+  b->buf[b->len] = msg_type;
+  b->buf[b->len + 1] = len;
+  memcpy(b->buf + b->len + sizeof(hu_batch_record_t), body, len);
+  b->len = (uint8_t)(b->len + need);
+  b->count++;
+
+  // Full frame: nothing else can join, send now
+  if (b->len + sizeof(hu_batch_record_t) >= HU_MAX_PAYLOAD_SIZE)
+  {
+    hu_batch_tx_flush(b);
+  }
+  return true;
+}
+
+void hu_batch_tx_poll(hu_batch_tx_t *b, uint32_t now_ms)
+{
+  if (b->count != 0 && now_ms - b->first_ms >= b->deadline_ms)
+  {
+    hu_batch_tx_flush(b);
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file hu_batch.h
+ * @brief HU_MSG_BATCH container: coalescing sender and record iterator
+ *
+ * Small messages (input events, single sensor readings) are packed as
+ * { msg_type, len, body } records into one frame, so they share one 9-byte
+ * header and one ESP-NOW channel access. The coalescer flushes when the next
+ * record does not fit or when the oldest record reaches its deadline.
+ * Latency-critical messages (EVENT_CRITICAL) should bypass it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_dispatch.h"
+#include "hu_frame_view.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Largest body a record can carry
+#define HU_BATCH_MAX_BODY (HU_MAX_PAYLOAD_SIZE - sizeof(hu_batch_record_t))
+
+// --- Receiver ---
+
+typedef struct
+{
+  const uint8_t *pos;
+  const uint8_t *end;
+} hu_batch_iter_t;
+
+void hu_batch_iter_init(hu_batch_iter_t *it, const hu_frame_view_t *batch);
+
+// Next record, body points into the frame. Returns false at the end or on a
+// malformed record (truncated, nested batch, size contract violated).
+bool hu_batch_next(hu_batch_iter_t *it, uint8_t *msg_type, const uint8_t **body, uint8_t *len);
+
+// Dispatches every record through d as if it were a frame of its own (outer
+// header with msg_type / payload_len replaced). Returns records dispatched.
+uint8_t hu_dispatch_batch(const hu_dispatcher_t *d, const hu_frame_view_t *batch);
+
+// --- Sender ---
+
+// Called on flush. msg_type is HU_MSG_BATCH, or the record's own type when
+// only one record is pending (sent without container overhead).
+typedef void (*hu_batch_flush_fn)(uint8_t dst_id, uint8_t msg_type, const uint8_t *payload, uint8_t len,
+                                  void *ctx);
+
+typedef struct
+{
+  uint8_t buf[HU_MAX_PAYLOAD_SIZE];
+  uint8_t len;
+  uint8_t count;
+  uint8_t dst_id;
+  uint16_t deadline_ms; // Max time the oldest record may wait
+  uint32_t first_ms;    // When the oldest pending record was added
+  hu_batch_flush_fn flush;
+  void *ctx;
+} hu_batch_tx_t;
+
+void hu_batch_tx_init(hu_batch_tx_t *b, uint8_t dst_id, uint16_t deadline_ms, hu_batch_flush_fn flush, void *ctx);
+
+// Appends a record, flushing first if it would not fit. Returns false if the
+// body can never fit or msg_type is HU_MSG_BATCH.
+bool hu_batch_tx_add(hu_batch_tx_t *b, uint8_t msg_type, const void *body, uint8_t len, uint32_t now_ms);
+
+// Flushes on deadline. Call from the TX task loop.
+void hu_batch_tx_poll(hu_batch_tx_t *b, uint32_t now_ms);
+
+void hu_batch_tx_flush(hu_batch_tx_t *b);
+
+#ifdef __cplusplus
+}
+#endif
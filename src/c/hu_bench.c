@@ -0,0 +1,270 @@
+/**
+ * @file hu_bench.c
+ * @brief Microbenchmarks of the RX / control path (HU_BENCH builds only)
+ */
+
+#include "hu_bench.h"
+
+#ifdef HU_BENCH
+
+#include "headunit_protocol.h"
+#include "hu_crc.h"
+#include "hu_dedup.h"
+#include "hu_dispatch.h"
+#include "hu_frame_view.h"
+#include "hu_profile_eval.h"
+#include "hu_route.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_SELF_ID 0x20
+#define BENCH_SOURCES 15 // Senders the dedup / route benchmarks cycle through
+#define BENCH_NODES 17   // One CMD_PROFILE_LOAD worth of nodes
+
+// Results go here so the compiler cannot drop the measured calls.
+static volatile uint32_t s_sink;
+
+// Benchmark state is static: hu_profile_eval_t and the dedup cache are too
+// large for a small task stack.
+static uint8_t s_frame[HU_MAX_FRAME_SIZE];
+static uint8_t s_frame_crc[HU_MAX_FRAME_SIZE];
+static uint8_t s_frame_max[HU_MAX_FRAME_SIZE];
+static hu_dispatcher_t s_dispatcher;
+static hu_dedup_cache_t s_dedup;
+static hu_route_table_t s_table;
+static hu_router_t s_router;
+static hu_profile_node_t s_nodes[BENCH_NODES];
+static hu_profile_eval_t s_eval;
+
+typedef struct
+{
+  const char *name;
+  uint32_t iterations; // Per unit of scale
+  void (*setup)(void);
+  void (*run)(uint32_t n);
+} bench_t;
+
+static uint16_t frame_build(uint8_t *out, uint8_t src_id, uint8_t dst_id, uint8_t msg_type, uint8_t payload_len)
+{
+  hu_frame_header_t hdr = {
+      .magic = HU_PROTOCOL_MAGIC,
+      .flags = 0,
+      .src_id = src_id,
+      .dst_id = dst_id,
+      .via_id = 0,
+      .msg_type = msg_type,
+      .seq_num = 0,
+      .payload_len = payload_len,
+  };
+  memcpy(out, &hdr, sizeof(hdr));
+  for (uint8_t i = 0; i < payload_len; i++)
+  {
+    out[sizeof(hdr) + i] = (uint8_t)(i * 37u + 11u);
+  }
+  return (uint16_t)(sizeof(hdr) + payload_len);
+}
+
+static void set_seq(uint8_t *frame, uint16_t seq)
+{
+  memcpy(frame + offsetof(hu_frame_header_t, seq_num), &seq, sizeof(seq));
+}
+
+static void on_msg(const hu_frame_view_t *frame, void *ctx)
+{
+  (void)ctx;
+  s_sink += hu_frame_view_payload(frame)[0];
+}
+
+static bool send_nothing(uint8_t to_id, const uint8_t *frame, uint16_t len, void *ctx)
+{
+  (void)to_id;
+  (void)frame;
+  (void)len;
+  (void)ctx;
+  return true;
+}
+
+// --- Setup ---
+
+static void setup_frames(void)
+{
+  uint8_t len = (uint8_t)sizeof(hu_payload_scale_data_t);
+  frame_build(s_frame, HU_ADDR_MIN_DYNAMIC, BENCH_SELF_ID, HU_MSG_DATA_SCALE, len);
+  frame_build(s_frame_crc, HU_ADDR_MIN_DYNAMIC, BENCH_SELF_ID, HU_MSG_DATA_SCALE, len);
+  hu_frame_seal(s_frame_crc);
+  frame_build(s_frame_max, HU_ADDR_MIN_DYNAMIC, BENCH_SELF_ID, HU_MSG_DATA_BLOCK, HU_MAX_PAYLOAD_SIZE);
+}
+
+static void setup_dispatch(void)
+{
+  setup_frames();
+  hu_dispatcher_init(&s_dispatcher, NULL);
+  hu_dispatcher_register(&s_dispatcher, HU_MSG_DATA_SCALE, on_msg);
+}
+
+static void setup_route(void)
+{
+  setup_frames();
+  hu_dedup_init(&s_dedup);
+  hu_route_table_init(&s_table, BENCH_SELF_ID);
+  hu_router_init(&s_router, &s_table, &s_dedup, send_nothing, NULL);
+}
+
+static void setup_profile(void)
+{
+  // Espresso-like shape: preinfusion ramp, hold, decline; mixed segments
+  for (uint8_t i = 0; i < BENCH_NODES; i++)
+  {
+    hu_profile_node_t *n = &s_nodes[i];
+    memset(n, 0, sizeof(*n));
+    n->time_offset_ms = (uint16_t)(i * 2000u);
+    n->config_flags = HU_NODE_CONFIG(i % 4 == 3 ? HU_INTERPOLATION_LINEAR : HU_INTERPOLATION_SPLINE,
+                                     i < 4 ? HU_PRIORITY_FLOW_IN : HU_PRIORITY_PRESSURE);
+    n->temp_target = (uint8_t)(186 + (i & 3));
+    n->temp_tol = 4;
+    n->press_target = (uint8_t)(i < 4 ? 20 + i * 15 : 90 - (i - 4) * 3);
+    n->press_tol = 5;
+    n->flow_in_target = (uint8_t)(i < 4 ? 40 : 20 + (i & 1) * 5);
+    n->flow_in_tol = 5;
+    n->flow_out_target = (uint8_t)(i < 4 ? 0 : 18 + (i % 3));
+    n->flow_out_tol = 4;
+    n->energy_target = (uint8_t)(100 + i);
+    n->energy_tol = 10;
+  }
+  hu_profile_eval_load(&s_eval, s_nodes, BENCH_NODES);
+}
+
+// --- Benchmarks ---
+
+static void run_frame_view(uint32_t n)
+{
+  hu_frame_view_t view;
+  uint16_t len = (uint16_t)(sizeof(hu_frame_header_t) + sizeof(hu_payload_scale_data_t));
+  for (uint32_t i = 0; i < n; i++)
+  {
+    s_sink += (uint32_t)hu_frame_view_init(&view, s_frame, len);
+  }
+}
+
+static void run_frame_view_crc(uint32_t n)
+{
+  hu_frame_view_t view;
+  uint16_t len = (uint16_t)(sizeof(hu_frame_header_t) + sizeof(hu_payload_scale_data_t) + HU_FRAME_CRC_SIZE);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    s_sink += (uint32_t)hu_frame_view_init(&view, s_frame_crc, len);
+  }
+}
+
+static void run_crc16_max(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+  {
+    s_sink += hu_crc16(0, s_frame_max, sizeof(hu_frame_header_t) + HU_MAX_PAYLOAD_SIZE);
+  }
+}
+
+static void run_dispatch(uint32_t n)
+{
+  hu_frame_view_t view;
+  hu_frame_view_init(&view, s_frame, sizeof(hu_frame_header_t) + sizeof(hu_payload_scale_data_t));
+  for (uint32_t i = 0; i < n; i++)
+  {
+    s_sink += (uint32_t)hu_dispatch(&s_dispatcher, &view);
+  }
+}
+
+static void run_dedup(uint32_t n)
+{
+  hu_dedup_init(&s_dedup);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    uint8_t src = (uint8_t)(HU_ADDR_MIN_DYNAMIC + i % BENCH_SOURCES);
+    s_sink += (uint32_t)hu_dedup_check_and_set(&s_dedup, src, (uint16_t)(i / BENCH_SOURCES));
+  }
+}
+
+static void run_route_rx(uint32_t n)
+{
+  // Consume path with dedup: a new seq_num from one of BENCH_SOURCES senders
+  uint16_t len = (uint16_t)(sizeof(hu_frame_header_t) + sizeof(hu_payload_scale_data_t));
+  hu_dedup_init(&s_dedup);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    s_frame[offsetof(hu_frame_header_t, src_id)] = (uint8_t)(HU_ADDR_MIN_DYNAMIC + i % BENCH_SOURCES);
+    set_seq(s_frame, (uint16_t)(i / BENCH_SOURCES));
+    s_sink += hu_route_rx(&s_router, s_frame, len);
+  }
+  s_frame[offsetof(hu_frame_header_t, src_id)] = HU_ADDR_MIN_DYNAMIC;
+  set_seq(s_frame, 0);
+}
+
+static void run_profile_load(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+  {
+    s_sink += hu_profile_eval_load(&s_eval, s_nodes, BENCH_NODES);
+  }
+}
+
+static void run_profile_eval(uint32_t n)
+{
+  // PID-tick pattern: t advances 10 ms per call, restarting after the last node
+  hu_profile_setpoint_t sp;
+  uint32_t end_ms = s_nodes[BENCH_NODES - 1].time_offset_ms + 500u;
+  uint32_t t = 0;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    hu_profile_eval_at(&s_eval, t, &sp);
+    s_sink += sp.target_q8[HU_AXIS_PRESS];
+    t = t + 10 < end_ms ? t + 10 : 0;
+  }
+}
+
+static const bench_t s_benches[HU_BENCH_COUNT] = {
+    {"frame_view", 20000, setup_frames, run_frame_view},
+    {"frame_view_crc", 5000, setup_frames, run_frame_view_crc},
+    {"crc16_239", 1000, setup_frames, run_crc16_max},
+    {"dispatch", 20000, setup_dispatch, run_dispatch},
+    {"dedup", 20000, NULL, run_dedup},
+    {"route_rx", 10000, setup_route, run_route_rx},
+    {"profile_load", 200, setup_profile, run_profile_load},
+    {"profile_eval", 10000, setup_profile, run_profile_eval},
+};
+
+uint8_t hu_bench_run(hu_bench_clock_fn clock, uint16_t scale, hu_bench_result_t *out, uint8_t max)
+{
+  uint32_t k = scale != 0 ? scale : 1;
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < HU_BENCH_COUNT && count < max; i++)
+  {
+    const bench_t *b = &s_benches[i];
+    uint32_t n = b->iterations * k;
+    if (b->setup != NULL)
+    {
+      b->setup();
+    }
+    b->run(n / 16 + 1); // Warm caches / flash cache lines first
+
+    uint32_t start = clock();
+    b->run(n);
+    uint32_t ticks = clock() - start;
+
+    out[count].name = b->name;
+    out[count].iterations = n;
+    out[count].ticks = ticks;
+    count++;
+  }
+  return count;
+}
+
+int hu_bench_format(const hu_bench_result_t *r, char *buf, size_t size)
+{
+  uint32_t n = r->iterations != 0 ? r->iterations : 1;
+  uint64_t per_op_x100 = ((uint64_t)r->ticks * 100u + n / 2) / n;
+  return snprintf(buf, size, "BENCH c.%s %lu.%02lu ticks/op", r->name, (unsigned long)(per_op_x100 / 100u),
+                  (unsigned long)(per_op_x100 % 100u));
+}
+
+#endif // HU_BENCH
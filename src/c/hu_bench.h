@@ -0,0 +1,55 @@
+/**
+ * @file hu_bench.h
+ * @brief Microbenchmarks of the RX / control path, host and on-target
+ *
+ * Built only with HU_BENCH defined, so production firmware carries none of
+ * it. The caller supplies a free-running tick counter (ESP32: the CPU cycle
+ * counter, esp_cpu_get_cycle_count(); host: a nanosecond clock) and prints
+ * the results, so the same code runs from a PlatformIO test
+ * (test/test_bench, on the board or the native env), a diagnostic command
+ * or a host build.
+ *
+ * Every benchmark runs a fixed workload with fixed inputs; results are
+ * comparable between commits on the same target. hu_bench_format() gives
+ * the one-line format shared with `python -m cd_protocol.bench`:
+ *
+ *     BENCH c.<name> <ticks_per_op> ticks/op
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef HU_BENCH
+
+// Monotonic counter; wraparound between two reads is handled (uint32_t).
+typedef uint32_t (*hu_bench_clock_fn)(void);
+
+typedef struct
+{
+  const char *name;
+  uint32_t iterations;
+  uint32_t ticks; // Total for all iterations
+} hu_bench_result_t;
+
+#define HU_BENCH_COUNT 8 // Benchmarks run by hu_bench_run()
+
+// Runs every benchmark `scale` times its base iteration count (0 = 1) and
+// fills up to max results. Keep the total per benchmark below one counter
+// wrap (~17 s at 240 MHz). Returns the number of results written.
+uint8_t hu_bench_run(hu_bench_clock_fn clock, uint16_t scale, hu_bench_result_t *out, uint8_t max);
+
+// "BENCH c.<name> <ticks/op, 2 decimals> ticks/op". Returns snprintf's result.
+int hu_bench_format(const hu_bench_result_t *r, char *buf, size_t size);
+
+#endif // HU_BENCH
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file hu_crc.h
+ * @brief Optional frame integrity trailer (HU_FLAG_CRC)
+ *
+ * CRC-16/X-25 (poly 0x1021 reflected, init/xorout 0xFFFF, check 0x906E) over
+ * header + payload, appended little-endian after the payload. The header
+ * flag is covered, so a flipped HU_FLAG_CRC bit is also detected.
+ *
+ * On ESP32 the ROM routine (esp_rom_crc16_le) is used; elsewhere a 512-byte
+ * table in flash. Define HU_CRC_NO_ROM to force the table.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Chainable like the ROM routine: start with 0, pass the previous result.
+uint16_t hu_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+// CRC-32/ISO-HDLC (zlib.crc32), chainable the same way. Used for whole
+// firmware images (hu_ota.h): ROM on ESP32, a 16-entry table elsewhere.
+uint32_t hu_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+// Sets HU_FLAG_CRC and writes the trailer after payload_len bytes of payload.
+// frame must have room for HU_FRAME_CRC_SIZE more bytes. Returns the new
+// frame length (header + payload + trailer).
+uint16_t hu_frame_seal(uint8_t *frame);
+
+// Checks the trailer of a frame with HU_FLAG_CRC. len is the buffer length;
+// false if the trailer is missing or does not match.
+bool hu_frame_crc_ok(const uint8_t *frame, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file hu_dedup.c
+ * @brief Sliding-window seq_num deduplication
+ */
+
+#include "hu_dedup.h"
+
+#include <stddef.h>
+#include <string.h>
+
+HU_STATIC_ASSERT(sizeof(hu_dedup_entry_t) == 8, "hu_dedup_entry_t must stay 8 bytes");
+HU_STATIC_ASSERT(HU_DEDUP_WINDOW == 32, "window is stored in a uint32_t bitmap");
+
+static hu_dedup_entry_t *slot_for(hu_dedup_cache_t *cache, uint8_t src_id)
+{
+  if (src_id == HU_ADDR_COORDINATOR)
+  {
+    return &cache->entries[0];
+  }
+  if (src_id >= HU_ADDR_MIN_DYNAMIC && src_id <= HU_ADDR_MAX_DYNAMIC)
+  {
+    return &cache->entries[1 + src_id - HU_ADDR_MIN_DYNAMIC];
+  }
+  return NULL;
+}
+
+void hu_dedup_init(hu_dedup_cache_t *cache)
+{
+  memset(cache, 0, sizeof(*cache));
+}
+
+hu_dedup_result_t hu_dedup_check_and_set(hu_dedup_cache_t *cache, uint8_t src_id, uint16_t seq_num)
+{
+  hu_dedup_entry_t *e = slot_for(cache, src_id);
+  if (e == NULL)
+  {
+    return HU_DEDUP_UNTRACKED;
+  }
+
+  // Signed distance on the uint16_t circle: > 0 means newer than top
+  int16_t ahead = (int16_t)(uint16_t)(seq_num - e->top);
+
+  if (!e->valid || ahead <= -HU_DEDUP_WINDOW)
+  {
+    // First frame, or too far behind: treat as restart of the sender
+    e->valid = 1;
+    e->top = seq_num;
+    e->seen = 1u;
+    return HU_DEDUP_NEW;
+  }
+
+  if (ahead > 0)
+  {
+    e->seen = ahead >= HU_DEDUP_WINDOW ? 0u : e->seen << ahead;
+    e->seen |= 1u;
+    e->top = seq_num;
+    return HU_DEDUP_NEW;
+  }
+
+  uint32_t bit = 1u << (uint16_t)(-ahead);
+  if (e->seen & bit)
+  {
+    return HU_DEDUP_DUPLICATE;
+  }
+  e->seen |= bit;
+  return HU_DEDUP_NEW;
+}
+
+void hu_dedup_reset_source(hu_dedup_cache_t *cache, uint8_t src_id)
+{
+  hu_dedup_entry_t *e = slot_for(cache, src_id);
+  if (e != NULL)
+  {
+    memset(e, 0, sizeof(*e));
+  }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file hu_dedup.h
+ * @brief Per-source sliding-window deduplication of seq_num
+ *
+ * One 32-frame bitmap window per logical source address (coordinator +
+ * dynamic range 0x10..0xF0). Check-and-set is O(1) and handles uint16_t
+ * wraparound via signed distance. Footprint is fixed: HU_DEDUP_SLOTS * 8 bytes
+ * (~1.8 KB), no allocation, so the cache can live next to the RX callback.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_DEDUP_WINDOW 32 // Frames remembered behind the newest seq_num
+
+// Slot 0 = coordinator, 1.. = HU_ADDR_MIN_DYNAMIC .. HU_ADDR_MAX_DYNAMIC
+#define HU_DEDUP_SLOTS (1 + HU_ADDR_MAX_DYNAMIC - HU_ADDR_MIN_DYNAMIC + 1)
+
+typedef enum
+{
+  HU_DEDUP_NEW = 0,       // First time seen: process
+  HU_DEDUP_DUPLICATE = 1, // Already seen inside the window: drop
+  HU_DEDUP_UNTRACKED = 2  // Source outside the tracked range (broadcast, unassigned)
+} hu_dedup_result_t;
+
+typedef struct
+{
+  uint32_t seen;    // Bit N = (top - N) received
+  uint16_t top;     // Highest seq_num accepted
+  uint8_t valid;    // Slot has history
+  uint8_t reserved; // Keeps the entry at 8 bytes
+} hu_dedup_entry_t;
+
+typedef struct
+{
+  hu_dedup_entry_t entries[HU_DEDUP_SLOTS];
+} hu_dedup_cache_t;
+
+void hu_dedup_init(hu_dedup_cache_t *cache);
+
+// Records (src_id, seq_num) and reports whether it was new. A seq_num that
+// falls further behind than the window is taken as a sender restart and
+// re-seeds the window instead of being dropped forever.
+hu_dedup_result_t hu_dedup_check_and_set(hu_dedup_cache_t *cache, uint8_t src_id, uint16_t seq_num);
+
+// Forget history of one source (e.g. after SYS_ASSIGN_ID or SYS_REBOOT)
+void hu_dedup_reset_source(hu_dedup_cache_t *cache, uint8_t src_id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file hu_discovery.c
+ * @brief Discovery slot and seen-filter hashing
+ */
+
+#include "hu_discovery.h"
+
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+#define FILTER_BITS (HU_DISCOVERY_FILTER_BYTES * 8)
+
+HU_STATIC_ASSERT(FILTER_BITS == 256, "filter bit indexes are taken from hash bytes");
+
+uint32_t hu_discovery_mac_hash(const uint8_t mac[6], uint8_t round)
+{
+  uint32_t h = FNV_OFFSET_BASIS;
+  h = (h ^ round) * FNV_PRIME;
+  for (int i = 0; i < 6; i++)
+  {
+    h = (h ^ mac[i]) * FNV_PRIME;
+  }
+  return h;
+}
+
+// k = 2: bit indexes from hash bytes 2 and 3 (bytes 0..1 pick the slot)
+static inline uint8_t filter_bit(uint32_t h, int k)
+{
+  return (uint8_t)(h >> (16 + 8 * k));
+}
+
+void hu_discovery_filter_add(uint8_t filter[HU_DISCOVERY_FILTER_BYTES], uint32_t mac_hash)
+{
+  for (int k = 0; k < 2; k++)
+  {
+    uint8_t bit = filter_bit(mac_hash, k);
+    filter[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+  }
+}
+
+bool hu_discovery_filter_test(const uint8_t filter[HU_DISCOVERY_FILTER_BYTES], uint32_t mac_hash)
+{
+  for (int k = 0; k < 2; k++)
+  {
+    uint8_t bit = filter_bit(mac_hash, k);
+    if (!(filter[bit >> 3] & (1u << (bit & 7))))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool read_payload(const uint8_t *payload, uint8_t len, void *out, uint8_t size, uint8_t legacy_size)
+{
+  if (len != size && len != legacy_size)
+  {
+    return false;
+  }
+  memset(out, 0, size);
+  memcpy(out, payload, len);
+  return true;
+}
+
+bool hu_discovery_req_read(const uint8_t *payload, uint8_t len, hu_payload_discovery_req_t *out)
+{
+  if (!read_payload(payload, len, out, sizeof(*out), HU_DISCOVERY_REQ_LEGACY_SIZE))
+  {
+    return false;
+  }
+  if (len == HU_DISCOVERY_REQ_LEGACY_SIZE)
+  {
+    // One slot of 0 ms would make every v0.2-polled node reply at once
+    out->slot_count = HU_DISCOVERY_REQ_LEGACY_SLOTS;
+    out->slot_ms = HU_DISCOVERY_REQ_LEGACY_SLOT_MS;
+  }
+  return true;
+}
+
+bool hu_discovery_res_read(const uint8_t *payload, uint8_t len, hu_payload_discovery_res_t *out)
+{
+  return read_payload(payload, len, out, sizeof(*out), HU_DISCOVERY_RES_LEGACY_SIZE);
+}
+
+bool hu_discovery_reply_delay(const hu_payload_discovery_req_t *req, const uint8_t mac[6], uint32_t *delay_ms)
+{
+  uint32_t h = hu_discovery_mac_hash(mac, req->round);
+  if (hu_discovery_filter_test(req->seen_filter, h))
+  {
+    return false;
+  }
+  uint8_t slots = req->slot_count == 0 ? 1 : req->slot_count;
+  *delay_ms = (uint32_t)((h & 0xFFFF) % slots) * req->slot_ms;
+  return true;
+}
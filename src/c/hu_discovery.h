@@ -0,0 +1,41 @@
+/**
+ * @file hu_discovery.h
+ * @brief Slotted, incremental SYS_DISCOVERY (deterministic reply slots)
+ *
+ * Replaces the random 0..100 ms jitter: the reply slot is derived from the
+ * node MAC and the round number, and nodes already heard are filtered out by
+ * the Bloom filter in the request. Round duration is slot_count * slot_ms.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// FNV-1a 32 over round + MAC (same as cd_protocol.discovery_mac_hash)
+uint32_t hu_discovery_mac_hash(const uint8_t mac[6], uint8_t round);
+
+void hu_discovery_filter_add(uint8_t filter[HU_DISCOVERY_FILTER_BYTES], uint32_t mac_hash);
+bool hu_discovery_filter_test(const uint8_t filter[HU_DISCOVERY_FILTER_BYTES], uint32_t mac_hash);
+
+// Copies a SYS_DISCOVERY_REQ / RES payload of either contract length into
+// out; fields missing from the legacy form read as 0, except the slots of a
+// v0.2 request (HU_DISCOVERY_REQ_LEGACY_SLOTS x _SLOT_MS). False on other
+// lengths.
+bool hu_discovery_req_read(const uint8_t *payload, uint8_t len, hu_payload_discovery_req_t *out);
+bool hu_discovery_res_read(const uint8_t *payload, uint8_t len, hu_payload_discovery_res_t *out);
+
+// Node side. Returns false if this MAC was already heard (stay silent);
+// otherwise the reply delay from receiving the request.
+bool hu_discovery_reply_delay(const hu_payload_discovery_req_t *req, const uint8_t mac[6], uint32_t *delay_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file hu_dispatch.c
+ * @brief Message contract table and dispatcher
+ */
+
+#include "hu_dispatch.h"
+
+#include "hu_batch.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define HU_EXACT(type) {HU_LEN_EXACT, (uint8_t)sizeof(type), 0}
+#define HU_ARRAY(head, item) {HU_LEN_ARRAY, (uint8_t)sizeof(head), (uint8_t)sizeof(item)}
+#define HU_LEGACY(type, old_len) {HU_LEN_LEGACY, (uint8_t)sizeof(type), (uint8_t)(old_len)}
+
+// Single source of truth for payload sizes. Entries not listed are HU_LEN_ANY.
+static const hu_msg_contract_t s_contracts[HU_MSG_TABLE_SIZE] = {
+    [HU_MSG_ACK] = HU_EXACT(hu_payload_ack_t),
+    [HU_MSG_ERROR] = HU_EXACT(hu_payload_error_t),
+    [HU_MSG_SYS_DISCOVERY_REQ] = HU_LEGACY(hu_payload_discovery_req_t, HU_DISCOVERY_REQ_LEGACY_SIZE),
+    [HU_MSG_SYS_DISCOVERY_RES] = HU_LEGACY(hu_payload_discovery_res_t, HU_DISCOVERY_RES_LEGACY_SIZE),
+    [HU_MSG_SYS_ASSIGN_ID] = HU_EXACT(hu_payload_assign_id_t),
+    [HU_MSG_SYS_ROUTE_UPDATE] = HU_ARRAY(hu_payload_route_update_t, hu_route_entry_t),
+    [HU_MSG_SYS_RSSI_SURVEY] = HU_ARRAY(hu_payload_rssi_survey_t, uint8_t),
+    [HU_MSG_SYS_RSSI_REPORT] = HU_ARRAY(hu_payload_rssi_report_t, hu_rssi_entry_t),
+    [HU_MSG_SYS_TIME_SYNC] = HU_EXACT(hu_payload_time_sync_t),
+    [HU_MSG_SYS_GROUP_SET] = HU_EXACT(hu_payload_group_set_t),
+    [HU_MSG_SYS_STATS_REQ] = HU_EXACT(hu_payload_stats_req_t),
+    [HU_MSG_CMD_SET_STATE] = HU_EXACT(hu_payload_set_state_t),
+    [HU_MSG_CMD_PROFILE_LOAD] = HU_ARRAY(hu_payload_profile_load_t, hu_profile_node_t),
+    [HU_MSG_CMD_HAPTIC_CFG] = HU_EXACT(hu_payload_haptic_cfg_t),
+    [HU_MSG_CMD_UI_WIDGET] = HU_ARRAY(hu_payload_ui_widget_t, uint8_t),
+    [HU_MSG_CMD_UI_MENU] = HU_EXACT(hu_payload_ui_menu_t),
+    [HU_MSG_CMD_PROFILE_CHUNK] = HU_ARRAY(hu_payload_profile_chunk_t, hu_profile_node_t),
+    [HU_MSG_CMD_PROFILE_ACTIVATE] = HU_EXACT(hu_payload_profile_activate_t),
+    [HU_MSG_CMD_TELEMETRY_CFG] = HU_EXACT(hu_payload_telemetry_cfg_t),
+    [HU_MSG_CMD_OTA_BEGIN] = HU_EXACT(hu_payload_ota_begin_t),
+    [HU_MSG_CMD_OTA_CHUNK] = HU_ARRAY(hu_payload_ota_chunk_t, uint8_t),
+    [HU_MSG_CMD_OTA_STATUS_REQ] = HU_ARRAY(hu_payload_ota_status_req_t, uint8_t),
+    [HU_MSG_CMD_OTA_CTRL] = HU_EXACT(hu_payload_ota_ctrl_t),
+    [HU_MSG_CMD_UI_UPDATE] = HU_ARRAY(hu_payload_ui_update_t, uint8_t),
+    [HU_MSG_EVENT_UI_INPUT] = HU_EXACT(hu_payload_event_input_t),
+    [HU_MSG_EVENT_FLOW_START] = HU_EXACT(hu_payload_flow_start_t),
+    [HU_MSG_EVENT_OTA_STATUS] = HU_ARRAY(hu_payload_ota_status_t, uint8_t),
+    [HU_MSG_EVENT_UI_ROTATE] = HU_EXACT(hu_payload_event_rotate_t),
+    [HU_MSG_DATA_SCALE] = HU_EXACT(hu_payload_scale_data_t),
+    [HU_MSG_DATA_BLOCK] = HU_ARRAY(hu_payload_data_block_t, uint8_t),
+    [HU_MSG_DATA_AGGREGATE] = HU_EXACT(hu_payload_data_aggregate_t),
+    [HU_MSG_DATA_STATS] = HU_ARRAY(hu_payload_stats_t, hu_stats_link_t),
+};
+
+HU_STATIC_ASSERT(sizeof(hu_payload_profile_load_t) + 17 * sizeof(hu_profile_node_t) <= HU_MAX_PAYLOAD_SIZE,
+                 "17 profile nodes must fit one frame");
+
+const hu_msg_contract_t *hu_msg_contract(uint8_t msg_type)
+{
+  return msg_type < HU_MSG_TABLE_SIZE ? &s_contracts[msg_type] : NULL;
+}
+
+static bool contract_allows(const hu_msg_contract_t *c, uint8_t len)
+{
+  switch (c->rule)
+  {
+  case HU_LEN_EXACT:
+    return len == c->head_size;
+  case HU_LEN_ARRAY:
+    return len >= c->head_size && (uint8_t)(len - c->head_size) % c->item_size == 0;
+  case HU_LEN_LEGACY:
+    return len == c->head_size || len == c->item_size;
+  default:
+    return true;
+  }
+}
+
+bool hu_msg_payload_len_valid(uint8_t msg_type, uint8_t payload_len)
+{
+  if (payload_len > HU_MAX_PAYLOAD_SIZE)
+  {
+    return false;
+  }
+  const hu_msg_contract_t *c = hu_msg_contract(msg_type);
+  return c == NULL || contract_allows(c, payload_len);
+}
+
+void hu_dispatcher_init(hu_dispatcher_t *d, void *ctx)
+{
+  memset(d->handlers, 0, sizeof(d->handlers));
+  d->ctx = ctx;
+}
+
+bool hu_dispatcher_register(hu_dispatcher_t *d, uint8_t msg_type, hu_msg_handler_t handler)
+{
+  if (msg_type >= HU_MSG_TABLE_SIZE)
+  {
+    return false;
+  }
+  d->handlers[msg_type] = handler;
+  return true;
+}
+
+hu_dispatch_result_t hu_dispatch(const hu_dispatcher_t *d, const hu_frame_view_t *frame)
+{
+  uint8_t type = hu_frame_view_msg_type(frame);
+  if (type >= HU_MSG_TABLE_SIZE)
+  {
+    return HU_DISPATCH_UNHANDLED;
+  }
+  // Re-checked here so frames not built by hu_frame_view_init() are safe too
+  if (!contract_allows(&s_contracts[type], hu_frame_view_payload_len(frame)))
+  {
+    return HU_DISPATCH_BAD_LEN;
+  }
+  if (type == HU_MSG_BATCH)
+  {
+    return hu_dispatch_batch(d, frame) > 0 ? HU_DISPATCH_OK : HU_DISPATCH_UNHANDLED;
+  }
+  hu_msg_handler_t handler = d->handlers[type];
+  if (handler == NULL)
+  {
+    return HU_DISPATCH_UNHANDLED;
+  }
+  handler(frame, d->ctx);
+  return HU_DISPATCH_OK;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file hu_dispatch.h
+ * @brief Table-driven message dispatch with a payload size contract
+ *
+ * One table indexed by msg_type holds the expected payload layout for every
+ * message. A frame whose length breaks the contract is rejected before any
+ * handler runs; valid frames are routed in O(1) by indexing the handler slot.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_frame_view.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Table covers msg_type 0x00 .. HU_MSG_TYPE_LAST
+#define HU_MSG_TABLE_SIZE (HU_MSG_TYPE_LAST + 1)
+
+typedef enum
+{
+  HU_LEN_ANY = 0,    // No payload struct: 0 .. HU_MAX_PAYLOAD_SIZE
+  HU_LEN_EXACT = 1,  // payload_len == head_size
+  HU_LEN_ARRAY = 2,  // payload_len == head_size + N * item_size
+  HU_LEN_LEGACY = 3  // payload_len == head_size, or item_size (older, shorter form)
+} hu_len_rule_t;
+
+typedef struct
+{
+  uint8_t rule;      // hu_len_rule_t
+  uint8_t head_size; // sizeof(payload struct) / fixed head
+  uint8_t item_size; // HU_LEN_ARRAY: sizeof(trailing item), HU_LEN_LEGACY: old length
+} hu_msg_contract_t;
+
+// Contract for msg_type, NULL for types outside the table
+const hu_msg_contract_t *hu_msg_contract(uint8_t msg_type);
+
+typedef void (*hu_msg_handler_t)(const hu_frame_view_t *frame, void *ctx);
+
+typedef enum
+{
+  HU_DISPATCH_OK = 0,
+  HU_DISPATCH_UNHANDLED = 1, // No handler registered / type outside table
+  HU_DISPATCH_BAD_LEN = 2    // Payload size contract violated
+} hu_dispatch_result_t;
+
+typedef struct
+{
+  hu_msg_handler_t handlers[HU_MSG_TABLE_SIZE];
+  void *ctx; // Passed to every handler
+} hu_dispatcher_t;
+
+void hu_dispatcher_init(hu_dispatcher_t *d, void *ctx);
+
+// Returns false if msg_type is outside the table.
+bool hu_dispatcher_register(hu_dispatcher_t *d, uint8_t msg_type, hu_msg_handler_t handler);
+
+// HU_MSG_BATCH frames are unpacked and each record dispatched (hu_batch.h).
+hu_dispatch_result_t hu_dispatch(const hu_dispatcher_t *d, const hu_frame_view_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
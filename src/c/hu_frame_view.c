@@ -0,0 +1,55 @@
+/**
+ * @file hu_frame_view.c
+ * @brief Single-pass frame validator
+ */
+
+#include "hu_frame_view.h"
+#include "hu_crc.h"
+
+#include <string.h>
+
+hu_frame_status_t hu_frame_view_init(hu_frame_view_t *view, const uint8_t *data, size_t len)
+{
+  if (view == NULL)
+  {
+    return HU_FRAME_ERR_NULL;
+  }
+  memset(view, 0, sizeof(*view));
+
+  if (data == NULL)
+  {
+    return HU_FRAME_ERR_NULL;
+  }
+  if (len < HU_FRAME_HEADER_SIZE)
+  {
+    return HU_FRAME_ERR_TRUNCATED;
+  }
+
+  const hu_frame_header_t *hdr = (const hu_frame_header_t *)(const void *)data;
+  if (hdr->magic != HU_PROTOCOL_MAGIC)
+  {
+    return HU_FRAME_ERR_MAGIC;
+  }
+  if (hdr->payload_len > HU_MAX_PAYLOAD_SIZE)
+  {
+    return HU_FRAME_ERR_OVERSIZE;
+  }
+
+  size_t frame_len = (size_t)HU_FRAME_HEADER_SIZE + hdr->payload_len;
+  if (len < frame_len)
+  {
+    return HU_FRAME_ERR_TRUNCATED;
+  }
+  if ((hdr->flags & HU_FLAG_CRC) && !hu_frame_crc_ok(data, len))
+  {
+    return HU_FRAME_ERR_CRC;
+  }
+  if (!hu_msg_payload_len_valid(hdr->msg_type, hdr->payload_len))
+  {
+    return HU_FRAME_ERR_PAYLOAD_SIZE;
+  }
+
+  view->data = data;
+  view->frame_len = (uint16_t)frame_len;
+  return HU_FRAME_OK;
+}
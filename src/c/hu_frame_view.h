@@ -0,0 +1,81 @@
+/**
+ * @file hu_frame_view.h
+ * @brief Zero-copy frame view over a raw CD-BUS receive buffer
+ *
+ * The buffer is validated once by hu_frame_view_init(); afterwards header and
+ * payload are read in place. All protocol structs are packed (alignment 1), so
+ * the typed pointers returned here are safe on any buffer address.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum
+{
+  HU_FRAME_OK = 0,
+  HU_FRAME_ERR_NULL = 1,         // No buffer
+  HU_FRAME_ERR_TRUNCATED = 2,    // Shorter than header + payload_len
+  HU_FRAME_ERR_MAGIC = 3,        // magic != HU_PROTOCOL_MAGIC
+  HU_FRAME_ERR_OVERSIZE = 4,     // payload_len > HU_MAX_PAYLOAD_SIZE
+  HU_FRAME_ERR_PAYLOAD_SIZE = 5, // payload_len violates msg_type contract
+  HU_FRAME_ERR_CRC = 6           // HU_FLAG_CRC set, trailer missing or wrong
+} hu_frame_status_t;
+
+// Validated view. Does not own the buffer: valid while the RX buffer is.
+typedef struct
+{
+  const uint8_t *data; // Points at the magic byte
+  uint16_t frame_len;  // Header + payload (CRC trailer / trailing bytes not included)
+} hu_frame_view_t;
+
+// Single-pass check of magic, payload_len bounds, the CRC trailer (if
+// flagged) and the per-msg_type payload size. On HU_FRAME_OK the view is
+// filled; otherwise it is zeroed.
+hu_frame_status_t hu_frame_view_init(hu_frame_view_t *view, const uint8_t *data, size_t len);
+
+// Payload size contract for a message type (table in hu_dispatch.c).
+// Types without a payload struct accept any length up to HU_MAX_PAYLOAD_SIZE.
+bool hu_msg_payload_len_valid(uint8_t msg_type, uint8_t payload_len);
+
+// --- In-place accessors (only on a view that passed hu_frame_view_init) ---
+
+static inline const hu_frame_header_t *hu_frame_view_header(const hu_frame_view_t *view)
+{
+  return (const hu_frame_header_t *)view->data;
+}
+
+static inline uint8_t hu_frame_view_msg_type(const hu_frame_view_t *view)
+{
+  return hu_frame_view_header(view)->msg_type;
+}
+
+static inline const uint8_t *hu_frame_view_payload(const hu_frame_view_t *view)
+{
+  return view->data + HU_FRAME_HEADER_SIZE;
+}
+
+static inline uint8_t hu_frame_view_payload_len(const hu_frame_view_t *view)
+{
+  return hu_frame_view_header(view)->payload_len;
+}
+
+// Typed payload pointer, NULL if the payload is shorter than the struct.
+// Usage: const hu_payload_scale_data_t *s = HU_FRAME_VIEW_PAYLOAD_AS(&v, hu_payload_scale_data_t);
+#define HU_FRAME_VIEW_PAYLOAD_AS(view, type)                   \
+  (hu_frame_view_payload_len(view) >= sizeof(type)             \
+       ? (const type *)(const void *)hu_frame_view_payload(view) \
+       : (const type *)0)
+
+#ifdef __cplusplus
+}
+#endif
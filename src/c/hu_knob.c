@@ -0,0 +1,259 @@
+/**
+ * @file hu_knob.c
+ * @brief Haptic knob loop: detent tracking, torque, rotation coalescing
+ */
+
+#include "hu_knob.h"
+
+#include <string.h>
+
+// hu_knob_t.pending: bits 0..15 delta (int16), 16..30 steps, 31 bound hit
+#define PENDING_STEPS_MAX 0x7FFF
+#define PENDING_LIMIT 0x80000000u
+
+static int32_t floor_div(int32_t a, int32_t b) // b > 0
+{
+  int32_t q = a / b;
+  return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+static int32_t floor_mod(int32_t a, int32_t b)
+{
+  return a - floor_div(a, b) * b;
+}
+
+static int32_t clamp32(int32_t v, int32_t lo, int32_t hi)
+{
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static bool has_menu(const hu_knob_t *k)
+{
+  return k->cfg.mode == KNOB_MODE_DETENTS && k->menu.item_count > 0;
+}
+
+static int32_t torque_max(const hu_knob_t *k)
+{
+  uint8_t strength = k->cfg.strength > 100 ? 100 : k->cfg.strength;
+  return (int32_t)HU_KNOB_TORQUE_MAX * strength / 100;
+}
+
+// Push back out of a wall, full strength HU_KNOB_WALL_CDEG deep
+static int32_t wall_torque(const hu_knob_t *k, int32_t depth_cdeg)
+{
+  int32_t d = depth_cdeg < HU_KNOB_WALL_CDEG ? depth_cdeg : HU_KNOB_WALL_CDEG;
+  return torque_max(k) * d / HU_KNOB_WALL_CDEG;
+}
+
+static int32_t position(const hu_knob_t *k)
+{
+  int32_t index = __atomic_load_n(&k->index, __ATOMIC_RELAXED); // Written by the motor loop
+  return has_menu(k) ? floor_mod(index, k->menu.item_count) : index;
+}
+
+static int32_t pending_delta(uint32_t p)
+{
+  return (int16_t)(uint16_t)(p & 0xFFFF);
+}
+
+static int32_t pending_steps(uint32_t p)
+{
+  return (int32_t)((p >> 16) & PENDING_STEPS_MAX);
+}
+
+// Config changed: the current angle is step `index`, nothing pending
+static void anchor(hu_knob_t *k, int32_t index, int32_t angle_cdeg)
+{
+  k->step_cdeg = 100;
+  if (k->cfg.mode == KNOB_MODE_DETENTS)
+  {
+    k->step_cdeg = 36000 / clamp32(k->cfg.param_1, 1, 360);
+  }
+  __atomic_store_n(&k->index, index, __ATOMIC_RELAXED);
+  k->origin_cdeg = angle_cdeg - index * k->step_cdeg;
+  __atomic_store_n(&k->at_limit, false, __ATOMIC_RELAXED);
+  __atomic_exchange_n(&k->pending, 0, __ATOMIC_ACQUIRE); // Steps under the old config are dropped
+  k->reported = position(k);
+}
+
+// Motor loop: adds d steps / a bound hit to what hu_knob_poll() takes next
+static void add_pending(hu_knob_t *k, int32_t d, bool limit, uint32_t now_ms)
+{
+  uint32_t old = __atomic_load_n(&k->pending, __ATOMIC_RELAXED);
+  uint32_t next;
+  do
+  {
+    if (old == 0)
+    {
+      __atomic_store_n(&k->first_ms, now_ms, __ATOMIC_RELAXED); // Published by the CAS below
+    }
+    int32_t delta = clamp32(pending_delta(old) + d, INT16_MIN, INT16_MAX);
+    int32_t steps = clamp32(pending_steps(old) + (d < 0 ? -d : d), 0, PENDING_STEPS_MAX);
+    next = (uint32_t)(uint16_t)delta | ((uint32_t)steps << 16) | ((limit || (old & PENDING_LIMIT)) ? PENDING_LIMIT : 0);
+  } while (!__atomic_compare_exchange_n(&k->pending, &old, next, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+void hu_knob_init(hu_knob_t *k, uint8_t source_index, uint16_t window_ms)
+{
+  memset(k, 0, sizeof(*k));
+  k->source_index = source_index;
+  k->window_ms = window_ms ? window_ms : HU_KNOB_WINDOW_MS;
+  k->cfg.mode = KNOB_MODE_FREE;
+  anchor(k, 0, 0);
+}
+
+void hu_knob_set_haptic(hu_knob_t *k, const hu_payload_haptic_cfg_t *cfg, int32_t angle_cdeg)
+{
+  // SPRING / SERVO centers are absolute: a new param_1 / param_2 / strength
+  // must not move the origin, or SERVO could never reach a given position
+  bool keep = cfg->mode == k->cfg.mode && (cfg->mode == KNOB_MODE_SPRING || cfg->mode == KNOB_MODE_SERVO);
+  k->cfg = *cfg;
+  if (!keep)
+  {
+    anchor(k, has_menu(k) ? k->menu.selected : 0, angle_cdeg);
+  }
+}
+
+void hu_knob_set_menu(hu_knob_t *k, const hu_payload_ui_menu_t *menu, int32_t angle_cdeg)
+{
+  k->menu = *menu;
+  if (k->menu.item_count > 0 && k->menu.selected >= k->menu.item_count)
+  {
+    k->menu.selected = (uint8_t)(k->menu.item_count - 1);
+  }
+  anchor(k, has_menu(k) ? k->menu.selected : 0, angle_cdeg);
+}
+
+uint8_t hu_knob_item(const hu_knob_t *k)
+{
+  return has_menu(k) ? (uint8_t)position(k) : 0;
+}
+
+int16_t hu_knob_update(hu_knob_t *k, int32_t angle_cdeg, uint32_t now_ms)
+{
+  int32_t rel = angle_cdeg - k->origin_cdeg;
+  int32_t step = k->step_cdeg;
+  int32_t half = step / 2;
+  int32_t hyst = step / HU_KNOB_HYSTERESIS;
+  bool bounded = has_menu(k) && !(k->menu.flags & HU_MENU_WRAP);
+
+  // Nearest step, moving only hyst past the midpoint
+  int32_t next = k->index;
+  int32_t up = floor_div(rel - half - hyst, step) + 1;
+  int32_t down = floor_div(rel + half + hyst, step);
+  if (up > next)
+  {
+    next = up;
+  }
+  else if (down < next)
+  {
+    next = down;
+  }
+  if (bounded)
+  {
+    next = clamp32(next, 0, k->menu.item_count - 1);
+  }
+  if (next != k->index)
+  {
+    int32_t d = next - k->index;
+    __atomic_store_n(&k->index, next, __ATOMIC_RELAXED);
+    add_pending(k, d, false, now_ms);
+  }
+
+  int32_t torque = 0;
+  bool limit = false;
+  int32_t max = torque_max(k);
+  switch (k->cfg.mode)
+  {
+  case KNOB_MODE_DETENTS:
+  {
+    int32_t x = rel - k->index * step; // Off the current detent
+    if (bounded && ((x > half && k->index == k->menu.item_count - 1) || (x < -half && k->index == 0)))
+    {
+      limit = true;
+      torque = x > 0 ? -wall_torque(k, x - half) : wall_torque(k, -x - half);
+      break;
+    }
+    int32_t snap = (k->cfg.param_2 > 0 && k->cfg.param_2 <= 100) ? k->cfg.param_2 : 100;
+    int32_t linear = half * snap / 100;
+    torque = -max * x / (linear > 0 ? linear : 1);
+    break;
+  }
+  case KNOB_MODE_SPRING:
+  case KNOB_MODE_SERVO:
+  {
+    int64_t dev = (int64_t)rel - (int64_t)k->cfg.param_1 * 100;
+    int64_t t = -dev * k->cfg.param_2 * k->cfg.strength / (100 * 100);
+    torque = (int32_t)(t > max ? max : (t < -max ? -max : t));
+    break;
+  }
+  case KNOB_MODE_BARRIER:
+  {
+    int32_t lo = k->cfg.param_1 * 100;
+    int32_t hi = k->cfg.param_2 * 100;
+    if (rel < lo)
+    {
+      limit = true;
+      torque = wall_torque(k, lo - rel);
+    }
+    else if (rel > hi)
+    {
+      limit = true;
+      torque = -wall_torque(k, rel - hi);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+
+  if (limit && !k->at_limit)
+  {
+    add_pending(k, 0, true, now_ms);
+  }
+  __atomic_store_n(&k->at_limit, limit, __ATOMIC_RELAXED);
+  return (int16_t)clamp32(torque, -max, max);
+}
+
+bool hu_knob_poll(hu_knob_t *k, uint32_t now_ms, hu_payload_event_rotate_t *out)
+{
+  if (__atomic_load_n(&k->pending, __ATOMIC_RELAXED) == 0)
+  {
+    return false;
+  }
+  // Leading edge goes out at once, then at most one event per window
+  if ((uint32_t)(now_ms - k->emit_ms) < k->window_ms)
+  {
+    return false;
+  }
+
+  uint32_t p = __atomic_exchange_n(&k->pending, 0, __ATOMIC_ACQUIRE);
+  uint32_t first_ms = __atomic_load_n(&k->first_ms, __ATOMIC_RELAXED);
+  bool hit = (p & PENDING_LIMIT) != 0;
+  int32_t pos = position(k);
+  bool menu = has_menu(k);
+  if (menu && pos == k->reported && !hit)
+  {
+    return false; // Wrapped all the way round or wobbled back: nothing to show
+  }
+
+  // Moving: the first pending step came right after the last event
+  bool moving = (uint32_t)(first_ms - k->emit_ms) <= k->window_ms;
+  uint32_t elapsed = now_ms - (moving ? k->emit_ms : first_ms);
+  uint32_t span = elapsed > k->window_ms ? elapsed : k->window_ms;
+  span = span > UINT16_MAX ? UINT16_MAX : span;
+
+  int32_t delta = pending_delta(p);
+  bool at_limit = hit || __atomic_load_n(&k->at_limit, __ATOMIC_RELAXED);
+  out->source_index = k->source_index;
+  out->flags = (uint8_t)((menu ? HU_ROTATE_MENU : 0) | (at_limit ? HU_ROTATE_AT_LIMIT : 0));
+  out->delta = (int16_t)delta;
+  out->steps = (uint16_t)pending_steps(p);
+  out->velocity = (int16_t)clamp32(delta * 1000 / (int32_t)span, INT16_MIN, INT16_MAX);
+  out->window_ms = (uint16_t)span;
+  out->position = pos;
+
+  k->emit_ms = now_ms;
+  k->reported = pos;
+  return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file hu_knob.h
+ * @brief On-node haptic knob loop: torque, menu hit-testing, coalesced rotation
+ *
+ * CMD_HAPTIC_CFG and CMD_UI_MENU configure the knob; from then on detents,
+ * springs and walls run locally at the motor loop rate, without a round trip
+ * to the RPi. Rotation is counted in steps (a detent, or one degree outside
+ * DETENTS mode) and reported as EVENT_UI_ROTATE: the first step after a
+ * pause goes out at once, further steps are summed and sent at most once per
+ * window. With a menu only item changes and bound hits are reported.
+ *
+ * Usage: hu_knob_update() from the motor loop (angle from the encoder, torque
+ * to the driver), hu_knob_poll() from the main loop; send EVENT_UI_ROTATE
+ * when it returns true. Clicks stay EVENT_UI_INPUT.
+ *
+ * The two loops may run in different tasks or cores. Pending rotation is one
+ * 32-bit word the motor loop adds to with compare-and-swap and
+ * hu_knob_poll() takes with an atomic exchange (GCC __atomic builtins, also in
+ * ESP-IDF), so no step is lost between them. hu_knob_init() and the
+ * configuration setters rewrite the whole state: call them from the motor
+ * loop context, or while it is stopped.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_KNOB_WINDOW_MS 30   // Default shortest spacing of rotation events
+#define HU_KNOB_HYSTERESIS 8   // Index moves 1/8 step past the midpoint
+#define HU_KNOB_TORQUE_MAX 1000 // Torque unit: per mille of the driver maximum
+#define HU_KNOB_WALL_CDEG 500  // BARRIER: full strength 5 degrees into the wall
+
+typedef struct
+{
+  uint8_t source_index; // Echoed in events
+  uint16_t window_ms;
+  hu_payload_haptic_cfg_t cfg;
+  hu_payload_ui_menu_t menu;
+  int32_t origin_cdeg; // Angle of step 0
+  int32_t step_cdeg;   // Detent width, 100 outside DETENTS
+  int32_t index;       // Current step (menu: unwrapped item)
+  bool at_limit;       // Against a wall / menu bound now
+
+  // Motor loop -> hu_knob_poll(), accessed atomically
+  uint32_t pending;  // Steps not reported yet: delta, step count, bound hit
+  uint32_t first_ms; // Time of the first pending step
+
+  // hu_knob_poll() only
+  uint32_t emit_ms; // Time of the last event
+  int32_t reported; // position of the last event
+} hu_knob_t;
+
+void hu_knob_init(hu_knob_t *k, uint8_t source_index, uint16_t window_ms);
+
+// CMD_HAPTIC_CFG. The current angle becomes step 0, or in DETENTS mode with
+// a menu the selected item. A parameter-only change within SPRING /
+// SERVO keeps the origin, so param_1 stays an absolute position.
+void hu_knob_set_haptic(hu_knob_t *k, const hu_payload_haptic_cfg_t *cfg, int32_t angle_cdeg);
+
+// CMD_UI_MENU: the current angle becomes menu->selected.
+void hu_knob_set_menu(hu_knob_t *k, const hu_payload_ui_menu_t *menu, int32_t angle_cdeg);
+
+// Motor loop tick: multi-turn encoder angle in centidegrees in, torque in
+// -HU_KNOB_TORQUE_MAX..HU_KNOB_TORQUE_MAX out (positive = increasing angle).
+int16_t hu_knob_update(hu_knob_t *k, int32_t angle_cdeg, uint32_t now_ms);
+
+// Selected menu item (0 without a menu)
+uint8_t hu_knob_item(const hu_knob_t *k);
+
+// true: *out is an EVENT_UI_ROTATE payload to send now.
+bool hu_knob_poll(hu_knob_t *k, uint32_t now_ms, hu_payload_event_rotate_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file hu_ota.c
+ * @brief Multicast firmware update, node side: chunk bitmap and status reports
+ */
+
+#include "hu_ota.h"
+
+#include <string.h>
+
+static bool chunk_received(const hu_ota_rx_t *rx, uint16_t index)
+{
+  return (rx->received[index >> 3] & (1u << (index & 7))) != 0;
+}
+
+static void set_failed(hu_ota_rx_t *rx, uint8_t error)
+{
+  if (rx->state == HU_OTA_STATE_RECEIVING)
+  {
+    rx->ops->abort(rx->ctx);
+  }
+  rx->state = HU_OTA_STATE_FAILED;
+  rx->error = error;
+}
+
+void hu_ota_rx_init(hu_ota_rx_t *rx, uint8_t device_type, const hu_ota_ops_t *ops, void *ctx)
+{
+  memset(rx, 0, sizeof(*rx));
+  rx->ops = ops;
+  rx->ctx = ctx;
+  rx->device_type = device_type;
+  rx->state = HU_OTA_STATE_IDLE;
+}
+
+void hu_ota_rx_restore(hu_ota_rx_t *rx, uint8_t session, uint8_t state)
+{
+  rx->image.session = session;
+  rx->state = state;
+  rx->error = HU_OTA_ERR_NONE;
+  rx->missing = 0;
+}
+
+hu_ota_rx_result_t hu_ota_rx_on_begin(hu_ota_rx_t *rx, const uint8_t *payload, uint8_t len)
+{
+  if (len != sizeof(hu_payload_ota_begin_t))
+  {
+    return HU_OTA_RX_ERR_SIZE;
+  }
+  hu_payload_ota_begin_t img;
+  memcpy(&img, payload, sizeof(img));
+  if (img.device_type != rx->device_type || rx->state == HU_OTA_STATE_PENDING_VERIFY)
+  {
+    return HU_OTA_RX_IGNORED;
+  }
+  // BEGIN is repeated for nodes that missed it; it must not restart them.
+  // A node that failed this session is re-armed instead.
+  if (rx->state != HU_OTA_STATE_IDLE && rx->state != HU_OTA_STATE_FAILED && img.session == rx->image.session)
+  {
+    return HU_OTA_RX_DUPLICATE;
+  }
+
+  if (rx->state == HU_OTA_STATE_RECEIVING)
+  {
+    rx->ops->abort(rx->ctx);
+  }
+  rx->image = img;
+  rx->state = HU_OTA_STATE_IDLE;
+  rx->error = HU_OTA_ERR_NONE;
+  rx->missing = 0;
+
+  uint32_t chunks = (img.image_size + HU_OTA_CHUNK_SIZE - 1) / HU_OTA_CHUNK_SIZE;
+  if (chunks == 0 || chunks > HU_OTA_MAX_CHUNKS || chunks != img.chunk_count)
+  {
+    set_failed(rx, HU_OTA_ERR_SIZE);
+    return HU_OTA_RX_FAILED;
+  }
+  if (!rx->ops->begin(&rx->image, rx->ctx))
+  {
+    set_failed(rx, HU_OTA_ERR_PREPARE);
+    return HU_OTA_RX_FAILED;
+  }
+  memset(rx->received, 0, sizeof(rx->received));
+  rx->missing = img.chunk_count;
+  rx->state = HU_OTA_STATE_RECEIVING;
+  return HU_OTA_RX_STARTED;
+}
+
+hu_ota_rx_result_t hu_ota_rx_on_chunk(hu_ota_rx_t *rx, const uint8_t *payload, uint8_t len)
+{
+  if (len < sizeof(hu_payload_ota_chunk_t))
+  {
+    return HU_OTA_RX_ERR_SIZE;
+  }
+  hu_payload_ota_chunk_t head;
+  memcpy(&head, payload, sizeof(head));
+  if (head.session != rx->image.session)
+  {
+    return HU_OTA_RX_IGNORED;
+  }
+  if (rx->state == HU_OTA_STATE_COMPLETE)
+  {
+    return HU_OTA_RX_DUPLICATE; // Repair round for other nodes
+  }
+  if (rx->state != HU_OTA_STATE_RECEIVING)
+  {
+    return HU_OTA_RX_IGNORED;
+  }
+  if (head.index >= rx->image.chunk_count)
+  {
+    return HU_OTA_RX_ERR_SIZE;
+  }
+
+  uint32_t offset = (uint32_t)head.index * HU_OTA_CHUNK_SIZE;
+  uint32_t expect = rx->image.image_size - offset;
+  expect = expect < HU_OTA_CHUNK_SIZE ? expect : HU_OTA_CHUNK_SIZE;
+  uint8_t data_len = (uint8_t)(len - sizeof(head));
+  if (data_len != expect)
+  {
+    return HU_OTA_RX_ERR_SIZE;
+  }
+  if (chunk_received(rx, head.index))
+  {
+    return HU_OTA_RX_DUPLICATE;
+  }
+
+  if (!rx->ops->write(offset, payload + sizeof(head), data_len, rx->ctx))
+  {
+    set_failed(rx, HU_OTA_ERR_WRITE);
+    return HU_OTA_RX_FAILED;
+  }
+  rx->received[head.index >> 3] |= (uint8_t)(1u << (head.index & 7));
+  if (--rx->missing > 0)
+  {
+    return HU_OTA_RX_STORED;
+  }
+
+  if (!rx->ops->finish(&rx->image, rx->ctx))
+  {
+    rx->state = HU_OTA_STATE_FAILED; // finish() already closed the image
+    rx->error = HU_OTA_ERR_VERIFY;
+    return HU_OTA_RX_FAILED;
+  }
+  rx->state = HU_OTA_STATE_COMPLETE;
+  return HU_OTA_RX_COMPLETE;
+}
+
+bool hu_ota_status_slot(const uint8_t *payload, uint8_t len, uint8_t self_id, uint32_t *delay_ms)
+{
+  if (len < sizeof(hu_payload_ota_status_req_t))
+  {
+    return false;
+  }
+  hu_payload_ota_status_req_t head;
+  memcpy(&head, payload, sizeof(head));
+  const uint8_t *probes = payload + sizeof(head);
+  uint8_t count = (uint8_t)(len - sizeof(head));
+  if (count == 0)
+  {
+    *delay_ms = 0;
+    return true;
+  }
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (probes[i] == self_id)
+    {
+      *delay_ms = (uint32_t)i * head.slot_ms;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint8_t hu_ota_rx_build_status(const hu_ota_rx_t *rx, const hu_payload_ota_status_req_t *req, uint8_t *out)
+{
+  hu_payload_ota_status_t head = {
+      .session = req->session,
+      .state = HU_OTA_STATE_IDLE,
+      .error = HU_OTA_ERR_NONE,
+      .missing = 0,
+      .base = req->from_chunk,
+  };
+  uint8_t *bitmap = out + sizeof(head);
+  uint8_t bytes = 0;
+
+  if (req->session == rx->image.session && rx->state != HU_OTA_STATE_IDLE)
+  {
+    head.state = rx->state;
+    head.error = rx->error;
+    head.missing = rx->missing;
+  }
+  if (head.state == HU_OTA_STATE_RECEIVING)
+  {
+    uint16_t count = rx->image.chunk_count;
+    uint16_t base = req->from_chunk;
+    while (base < count && chunk_received(rx, base))
+    {
+      base++;
+    }
+    head.base = base;
+    memset(bitmap, 0, HU_OTA_BITMAP_MAX);
+    uint32_t span = (uint32_t)HU_OTA_BITMAP_MAX * 8;
+    for (uint32_t i = 0; i < span && base + i < count; i++)
+    {
+      if (!chunk_received(rx, (uint16_t)(base + i)))
+      {
+        bitmap[i >> 3] |= (uint8_t)(1u << (i & 7));
+        bytes = (uint8_t)((i >> 3) + 1);
+      }
+    }
+  }
+
+  memcpy(out, &head, sizeof(head));
+  return (uint8_t)(sizeof(head) + bytes);
+}
+
+bool hu_ota_rx_on_ctrl(hu_ota_rx_t *rx, const hu_payload_ota_ctrl_t *ctrl)
+{
+  if (ctrl->session != rx->image.session || rx->state == HU_OTA_STATE_IDLE)
+  {
+    return false;
+  }
+  switch (ctrl->op)
+  {
+  case HU_OTA_OP_APPLY:
+    return rx->state == HU_OTA_STATE_COMPLETE;
+  case HU_OTA_OP_COMMIT:
+    if (rx->state != HU_OTA_STATE_PENDING_VERIFY)
+    {
+      return false;
+    }
+    rx->state = HU_OTA_STATE_IDLE;
+    return true;
+  case HU_OTA_OP_ROLLBACK:
+    return rx->state == HU_OTA_STATE_PENDING_VERIFY;
+  case HU_OTA_OP_ABORT:
+    if (rx->state == HU_OTA_STATE_PENDING_VERIFY)
+    {
+      return false; // Running image: only COMMIT or ROLLBACK
+    }
+    if (rx->state == HU_OTA_STATE_RECEIVING)
+    {
+      rx->ops->abort(rx->ctx);
+    }
+    rx->state = HU_OTA_STATE_IDLE;
+    rx->missing = 0;
+    return true;
+  default:
+    return false;
+  }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file hu_ota.h
+ * @brief Node side of the multicast firmware update (CMD_OTA_*, EVENT_OTA_STATUS)
+ *
+ * The RPi sends the image once, as numbered chunks to a type group or
+ * broadcast, with no per-chunk ACK. hu_ota_rx_t writes each chunk straight to
+ * its offset in the update partition (chunks arrive in any order) and keeps a
+ * received bitmap; on OTA_STATUS_REQ the node answers in its slot with the
+ * chunks it still misses, and the RPi resends only the union of all reports.
+ * Flash access goes through hu_ota_ops_t (ESP-IDF: esp_ota_begin with the
+ * image size, esp_ota_write_with_offset, esp_ota_end).
+ *
+ * The Pending Verify / commit / rollback flow is unchanged: OTA_CTRL APPLY
+ * boots the complete image, COMMIT or ROLLBACK ends the update. While the
+ * running image is pending, the other partition holds the rollback image,
+ * so a new OTA_BEGIN is ignored until then.
+ *
+ * Call from the task that owns the flash (RX ring consumer), not from the
+ * ESP-NOW receive callback: a chunk write takes milliseconds.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_OTA_BITMAP_MAX (HU_MAX_PAYLOAD_SIZE - sizeof(hu_payload_ota_status_t)) // Bytes per report
+
+typedef struct
+{
+  // Prepare the update partition for image->image_size bytes (erases it)
+  bool (*begin)(const hu_payload_ota_begin_t *image, void *ctx);
+  // Write len bytes at offset into the update partition
+  bool (*write)(uint32_t offset, const uint8_t *data, uint8_t len, void *ctx);
+  // Every chunk written: check image_crc32 (hu_crc32 over a read-back) and
+  // close the image (esp_ota_end). false = not bootable.
+  bool (*finish)(const hu_payload_ota_begin_t *image, void *ctx);
+  // Drop a partly written image (esp_ota_abort). A complete image is
+  // closed already; it is simply never booted.
+  void (*abort)(void *ctx);
+} hu_ota_ops_t;
+
+typedef enum
+{
+  HU_OTA_RX_IGNORED = 0,   // Other device type / session, or not receiving
+  HU_OTA_RX_STARTED = 1,   // OTA_BEGIN accepted, partition prepared
+  HU_OTA_RX_STORED = 2,    // Chunk written, more missing
+  HU_OTA_RX_DUPLICATE = 3, // Chunk / BEGIN already had
+  HU_OTA_RX_COMPLETE = 4,  // Last chunk written and image verified
+  HU_OTA_RX_FAILED = 5,    // Session failed now (state FAILED, see error)
+  HU_OTA_RX_ERR_SIZE = 6   // Malformed payload
+} hu_ota_rx_result_t;
+
+typedef struct
+{
+  const hu_ota_ops_t *ops;
+  void *ctx;
+  uint8_t device_type; // This node's hu_device_type_t
+  uint8_t state;       // HU_OTA_STATE_*
+  uint8_t error;       // HU_OTA_ERR_*
+  uint16_t missing;
+  hu_payload_ota_begin_t image;            // Current session
+  uint8_t received[HU_OTA_MAX_CHUNKS / 8]; // Bit per chunk
+} hu_ota_rx_t;
+
+void hu_ota_rx_init(hu_ota_rx_t *rx, uint8_t device_type, const hu_ota_ops_t *ops, void *ctx);
+
+// After a reboot into the new image (esp_ota_get_state_partition() ==
+// ESP_OTA_IMG_PENDING_VERIFY): report PENDING_VERIFY for the session the
+// application kept in NVS, so COMMIT / ROLLBACK are accepted.
+void hu_ota_rx_restore(hu_ota_rx_t *rx, uint8_t session, uint8_t state);
+
+// OTA_BEGIN: a new session (for this device type) aborts a running one.
+// Repeating the current session's BEGIN is DUPLICATE, except after FAILED:
+// then the session starts over.
+hu_ota_rx_result_t hu_ota_rx_on_begin(hu_ota_rx_t *rx, const uint8_t *payload, uint8_t len);
+
+hu_ota_rx_result_t hu_ota_rx_on_chunk(hu_ota_rx_t *rx, const uint8_t *payload, uint8_t len);
+
+// OTA_STATUS_REQ: false if this node is not polled, otherwise the reply
+// delay from the request in *delay_ms.
+bool hu_ota_status_slot(const uint8_t *payload, uint8_t len, uint8_t self_id, uint32_t *delay_ms);
+
+// Writes the EVENT_OTA_STATUS payload for a request (at least
+// HU_MAX_PAYLOAD_SIZE bytes) into out and returns its length. A request for
+// another session reports IDLE.
+uint8_t hu_ota_rx_build_status(const hu_ota_rx_t *rx, const hu_payload_ota_status_req_t *req, uint8_t *out);
+
+// OTA_CTRL: true if the op is valid now. The caller then performs it
+// (APPLY: esp_ota_set_boot_partition + esp_restart at execute_at_ms;
+// COMMIT: esp_ota_mark_app_valid_cancel_rollback; ROLLBACK:
+// esp_ota_mark_app_invalid_rollback_and_reboot). ABORT is done here. false:
+// answer HU_MSG_ERROR HU_ERR_OTA_STATE.
+bool hu_ota_rx_on_ctrl(hu_ota_rx_t *rx, const hu_payload_ota_ctrl_t *ctrl);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file hu_profile_cache.c
+ * @brief LRU profile cache
+ */
+
+#include "hu_profile_cache.h"
+
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+uint32_t hu_profile_hash(const hu_profile_node_t *nodes, uint8_t count)
+{
+  const uint8_t *p = (const uint8_t *)(const void *)nodes;
+  size_t len = (size_t)count * sizeof(hu_profile_node_t);
+  uint32_t h = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < len; i++)
+  {
+    h ^= p[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+void hu_profile_cache_init(hu_profile_cache_t *cache)
+{
+  memset(cache, 0, sizeof(*cache));
+}
+
+const hu_profile_cache_entry_t *hu_profile_cache_store(hu_profile_cache_t *cache, const hu_profile_asm_t *pa)
+{
+  if (!hu_profile_asm_complete(pa))
+  {
+    return NULL;
+  }
+  const hu_profile_buf_t *b = hu_profile_asm_current(pa);
+
+  // Same profile_id replaces its old version; otherwise empty or LRU slot
+  hu_profile_cache_entry_t *slot = &cache->entries[0];
+  for (uint8_t i = 0; i < HU_PROFILE_CACHE_SLOTS; i++)
+  {
+    hu_profile_cache_entry_t *e = &cache->entries[i];
+    if (e->total_nodes != 0 && e->profile_id == b->profile_id)
+    {
+      slot = e;
+      break;
+    }
+    if (e->total_nodes == 0 || (slot->total_nodes != 0 && e->last_used < slot->last_used))
+    {
+      slot = e;
+    }
+  }
+
+  slot->profile_id = b->profile_id;
+  slot->total_nodes = b->total_nodes;
+  memcpy(slot->nodes, b->nodes, (size_t)b->total_nodes * sizeof(hu_profile_node_t));
+  slot->content_hash = hu_profile_hash(slot->nodes, slot->total_nodes);
+  slot->last_used = ++cache->clock;
+  return slot;
+}
+
+const hu_profile_cache_entry_t *hu_profile_cache_find(hu_profile_cache_t *cache,
+                                                      const hu_payload_profile_activate_t *req)
+{
+  for (uint8_t i = 0; i < HU_PROFILE_CACHE_SLOTS; i++)
+  {
+    hu_profile_cache_entry_t *e = &cache->entries[i];
+    if (e->total_nodes != 0 && e->profile_id == req->profile_id && e->total_nodes == req->total_nodes &&
+        e->content_hash == req->content_hash)
+    {
+      e->last_used = ++cache->clock;
+      return e;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file hu_profile_cache.h
+ * @brief Node-side cache of recent profiles keyed by profile_id + content hash
+ *
+ * Before a shot the RPi sends CMD_PROFILE_ACTIVATE { profile_id, total_nodes,
+ * content_hash }. On a hit the node runs the cached nodes and ACKs; on a miss
+ * it answers ERROR HU_ERR_PROFILE_NOT_CACHED and the RPi falls back to the
+ * full CMD_PROFILE_LOAD / CMD_PROFILE_CHUNK upload. Fixed RAM, LRU eviction.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_profile_stream.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_PROFILE_CACHE_SLOTS 4 // ~3.4 KB with HU_PROFILE_MAX_NODES = 64
+
+typedef struct
+{
+  uint8_t profile_id;
+  uint8_t total_nodes; // 0 = empty slot
+  uint32_t content_hash;
+  uint32_t last_used; // LRU stamp
+  hu_profile_node_t nodes[HU_PROFILE_MAX_NODES];
+} hu_profile_cache_entry_t;
+
+typedef struct
+{
+  hu_profile_cache_entry_t entries[HU_PROFILE_CACHE_SLOTS];
+  uint32_t clock; // Monotonic use counter
+} hu_profile_cache_t;
+
+// FNV-1a 32 over the packed node bytes (same as cd_protocol.profile_hash)
+uint32_t hu_profile_hash(const hu_profile_node_t *nodes, uint8_t count);
+
+void hu_profile_cache_init(hu_profile_cache_t *cache);
+
+// Stores the current upload of pa once complete, replacing the same
+// profile_id or the least recently used slot. Returns the stored entry, NULL
+// if incomplete.
+const hu_profile_cache_entry_t *hu_profile_cache_store(hu_profile_cache_t *cache, const hu_profile_asm_t *pa);
+
+// Lookup for CMD_PROFILE_ACTIVATE. NULL on miss (reply HU_ERR_PROFILE_NOT_CACHED).
+const hu_profile_cache_entry_t *hu_profile_cache_find(hu_profile_cache_t *cache,
+                                                      const hu_payload_profile_activate_t *req);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file hu_profile_eval.c
+ * @brief Fixed-point profile interpolation
+ */
+
+#include "hu_profile_eval.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// Targets/tolerances are laid out as {target, tol} pairs per axis
+HU_STATIC_ASSERT(offsetof(hu_profile_node_t, press_target) == offsetof(hu_profile_node_t, temp_target) + 2,
+                 "axis pairs must be contiguous");
+HU_STATIC_ASSERT(offsetof(hu_profile_node_t, energy_tol) == offsetof(hu_profile_node_t, temp_target) + 9,
+                 "axis pairs must be contiguous");
+
+#define Q8_MAX (255 << HU_PROFILE_Q)
+#define SPLINE_S_BITS 12 // Segment position resolution for the cubic
+
+static inline uint8_t node_target(const hu_profile_node_t *n, int axis)
+{
+  return ((const uint8_t *)(const void *)n)[offsetof(hu_profile_node_t, temp_target) + 2 * axis];
+}
+
+static inline uint8_t node_tol(const hu_profile_node_t *n, int axis)
+{
+  return ((const uint8_t *)(const void *)n)[offsetof(hu_profile_node_t, temp_target) + 2 * axis + 1];
+}
+
+static inline uint16_t clamp_q8(int32_t v)
+{
+  return (uint16_t)(v < 0 ? 0 : (v > Q8_MAX ? Q8_MAX : v));
+}
+
+// v0 + (v1 - v0) * frac, frac in Q16, result in Q8
+static inline int32_t lerp_q8(uint8_t v0, uint8_t v1, uint32_t frac_q16)
+{
+  return ((int32_t)v0 << HU_PROFILE_Q) + (((int32_t)v1 - (int32_t)v0) * (int32_t)frac_q16) / (1 << 8);
+}
+
+// Fritsch-Butland: harmonic mean of neighbouring secants, 0 at extrema
+static int32_t node_tangent(const hu_profile_node_t *nodes, uint8_t k, uint8_t count, int axis)
+{
+  if (k == 0 || k + 1 >= count)
+  {
+    return 0;
+  }
+  uint32_t dt0 = (uint32_t)nodes[k].time_offset_ms - nodes[k - 1].time_offset_ms;
+  uint32_t dt1 = (uint32_t)nodes[k + 1].time_offset_ms - nodes[k].time_offset_ms;
+  if (dt0 == 0 || dt1 == 0)
+  {
+    return 0;
+  }
+  int32_t s0 = (((int32_t)node_target(&nodes[k], axis) - node_target(&nodes[k - 1], axis)) * 65536) / (int32_t)dt0;
+  int32_t s1 = (((int32_t)node_target(&nodes[k + 1], axis) - node_target(&nodes[k], axis)) * 65536) / (int32_t)dt1;
+  if (s0 == 0 || s1 == 0 || (s0 < 0) != (s1 < 0))
+  {
+    return 0;
+  }
+  return (int32_t)((2 * (int64_t)s0 * s1) / ((int64_t)s0 + s1));
+}
+
+// Recomputes segment/tangent data for nodes [from, ev->count)
+static bool prepare(hu_profile_eval_t *ev, uint8_t from)
+{
+  for (uint8_t i = from; i < ev->count; i++)
+  {
+    if (i + 1 < ev->count)
+    {
+      if (ev->nodes[i + 1].time_offset_ms < ev->nodes[i].time_offset_ms)
+      {
+        return false;
+      }
+      uint32_t dt = (uint32_t)ev->nodes[i + 1].time_offset_ms - ev->nodes[i].time_offset_ms;
+      // Rounded up so that exact fractions (e.g. dt / 2) come out exact
+      ev->inv_dt_q32[i] = dt == 0 ? 0 : (dt == 1 ? UINT32_MAX : (uint32_t)((((uint64_t)1 << 32) + dt - 1) / dt));
+    }
+    for (int a = 0; a < HU_AXIS_COUNT; a++)
+    {
+      ev->tangent_q16[i][a] = node_tangent(ev->nodes, i, ev->count, a);
+    }
+  }
+  return true;
+}
+
+bool hu_profile_eval_load(hu_profile_eval_t *ev, const hu_profile_node_t *nodes, uint8_t count)
+{
+  memset(ev, 0, sizeof(*ev));
+  if (nodes == NULL || count == 0 || count > HU_PROFILE_MAX_NODES)
+  {
+    return false;
+  }
+  ev->nodes = nodes;
+  ev->count = count;
+  return prepare(ev, 0);
+}
+
+bool hu_profile_eval_extend(hu_profile_eval_t *ev, uint8_t count)
+{
+  uint8_t old = ev->count;
+  if (old == 0 || count > HU_PROFILE_MAX_NODES)
+  {
+    return false; // Not loaded (nodes may be NULL) or too large
+  }
+  if (count <= old)
+  {
+    return true;
+  }
+  // Validate before touching anything so a bad chunk leaves ev as it was
+  for (uint8_t i = (uint8_t)(old - 1); i + 1 < count; i++)
+  {
+    if (ev->nodes[i + 1].time_offset_ms < ev->nodes[i].time_offset_ms)
+    {
+      return false;
+    }
+  }
+  ev->count = count;
+  // The old last node gains a neighbour: its tangent changes, which feeds
+  // both the segment it ends (old - 2) and the one it now starts (old - 1)
+  if (ev->cursor + 2 >= old)
+  {
+    ev->coef_valid = false;
+  }
+  return prepare(ev, (uint8_t)(old - 1));
+}
+
+// Cubic Hermite in power form for the active segment, s in Q12
+static void build_spline(hu_profile_eval_t *ev)
+{
+  uint8_t i = ev->cursor;
+  const hu_profile_node_t *n0 = &ev->nodes[i];
+  const hu_profile_node_t *n1 = &ev->nodes[i + 1];
+  int64_t dt = (int64_t)n1->time_offset_ms - n0->time_offset_ms;
+
+  for (int a = 0; a < HU_AXIS_COUNT; a++)
+  {
+    int32_t v0 = (int32_t)node_target(n0, a) << HU_PROFILE_Q;
+    int32_t delta = ((int32_t)node_target(n1, a) << HU_PROFILE_Q) - v0;
+
+    // End slopes scaled to the segment (Q8). Clamped to 2*delta, which keeps
+    // the curve monotone and bounds the Horner terms below 2^31.
+    int32_t lim = delta < 0 ? -2 * delta : 2 * delta;
+    int32_t d0 = (int32_t)((ev->tangent_q16[i][a] * dt) / 256);
+    int32_t d1 = (int32_t)((ev->tangent_q16[i + 1][a] * dt) / 256);
+    d0 = d0 > lim ? lim : (d0 < -lim ? -lim : d0);
+    d1 = d1 > lim ? lim : (d1 < -lim ? -lim : d1);
+
+    ev->coef[a][0] = v0;
+    ev->coef[a][1] = d0;
+    ev->coef[a][2] = 3 * delta - 2 * d0 - d1;
+    ev->coef[a][3] = -2 * delta + d0 + d1;
+  }
+  ev->coef_valid = true;
+}
+
+static void hold(const hu_profile_node_t *n, hu_profile_setpoint_t *out)
+{
+  for (int a = 0; a < HU_AXIS_COUNT; a++)
+  {
+    out->target_q8[a] = (uint16_t)(node_target(n, a) << HU_PROFILE_Q);
+    out->tol_q8[a] = (uint16_t)(node_tol(n, a) << HU_PROFILE_Q);
+  }
+}
+
+void hu_profile_eval_at(hu_profile_eval_t *ev, uint32_t t_ms, hu_profile_setpoint_t *out)
+{
+  memset(out, 0, sizeof(*out));
+  if (ev->count == 0)
+  {
+    out->finished = true;
+    return;
+  }
+
+  // Monotonic cursor: amortised O(1) per tick
+  if (ev->cursor > 0 && t_ms < ev->nodes[ev->cursor].time_offset_ms)
+  {
+    ev->cursor = 0;
+    ev->coef_valid = false;
+  }
+  while (ev->cursor + 1 < ev->count && t_ms >= ev->nodes[ev->cursor + 1].time_offset_ms)
+  {
+    ev->cursor++;
+    ev->coef_valid = false;
+  }
+
+  uint8_t i = ev->cursor;
+  const hu_profile_node_t *n0 = &ev->nodes[i];
+  hu_interpolation_t mode = HU_NODE_INTERPOLATION(n0->config_flags);
+  out->segment = i;
+  out->priority = HU_NODE_PRIORITY(n0->config_flags);
+  out->interpolation = mode;
+
+  bool last = (i + 1 >= ev->count);
+  out->finished = last && t_ms >= n0->time_offset_ms;
+  if (last || t_ms < n0->time_offset_ms || mode == HU_INTERPOLATION_STEP || ev->inv_dt_q32[i] == 0)
+  {
+    hold(n0, out);
+    return;
+  }
+
+  const hu_profile_node_t *n1 = &ev->nodes[i + 1];
+  uint32_t elapsed = t_ms - n0->time_offset_ms;
+  uint32_t frac_q16 = (uint32_t)(((uint64_t)elapsed * ev->inv_dt_q32[i]) >> 16);
+
+  for (int a = 0; a < HU_AXIS_COUNT; a++)
+  {
+    out->tol_q8[a] = clamp_q8(lerp_q8(node_tol(n0, a), node_tol(n1, a), frac_q16));
+  }
+
+  if (mode == HU_INTERPOLATION_SPLINE)
+  {
+    if (!ev->coef_valid)
+    {
+      build_spline(ev);
+    }
+    int32_t s = (int32_t)(frac_q16 >> (16 - SPLINE_S_BITS));
+    for (int a = 0; a < HU_AXIS_COUNT; a++)
+    {
+      const int32_t *c = ev->coef[a];
+      int32_t r = (c[3] * s) / (1 << SPLINE_S_BITS) + c[2];
+      r = (r * s) / (1 << SPLINE_S_BITS) + c[1];
+      r = (r * s) / (1 << SPLINE_S_BITS) + c[0];
+      out->target_q8[a] = clamp_q8(r);
+    }
+    return;
+  }
+
+  for (int a = 0; a < HU_AXIS_COUNT; a++)
+  {
+    out->target_q8[a] = clamp_q8(lerp_q8(node_target(n0, a), node_target(n1, a), frac_q16));
+  }
+}
@@ -0,0 +1,85 @@
+/**
+ * @file hu_profile_eval.h
+ * @brief Fixed-point evaluator for hu_profile_node_t profiles
+ *
+ * Turns the compact node array into setpoints for all five axes at a given
+ * shot time. Segment data (1/dt, spline tangents) is precomputed at load; a
+ * monotonic cursor makes each PID tick O(1). Integer math only.
+ *
+ * Segment i runs from node i to node i+1 using node i's config_flags:
+ *  - LINEAR: straight line between the two nodes.
+ *  - SPLINE: monotone cubic Hermite (Fritsch-Butland tangents) on targets,
+ *            linear on tolerances. Never overshoots the node values.
+ *  - STEP:   node i held until node i+1.
+ * Before the first node its values are held, after the last node likewise.
+ *
+ * Outputs are in Q8 raw LSB units: value / 256 * LSB (0.5 C, 0.1 bar, ...).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_profile_stream.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_PROFILE_Q 8 // Output fraction bits
+
+typedef enum
+{
+  HU_AXIS_TEMP = 0,
+  HU_AXIS_PRESS = 1,
+  HU_AXIS_FLOW_IN = 2,
+  HU_AXIS_FLOW_OUT = 3,
+  HU_AXIS_ENERGY = 4,
+  HU_AXIS_COUNT = 5
+} hu_profile_axis_t;
+
+typedef struct
+{
+  uint16_t target_q8[HU_AXIS_COUNT]; // Raw LSB * 256
+  uint16_t tol_q8[HU_AXIS_COUNT];    // Raw LSB * 256
+  uint8_t priority;                  // hu_profile_priority_t of the active segment
+  uint8_t interpolation;             // hu_interpolation_t of the active segment
+  uint8_t segment;                   // Index of the node that starts the segment
+  bool finished;                     // Time is at or past the last node
+} hu_profile_setpoint_t;
+
+typedef struct
+{
+  const hu_profile_node_t *nodes; // Not owned (e.g. hu_profile_buf_t / cache entry)
+  uint8_t count;
+  uint8_t cursor;
+
+  // Load-time precompute, per segment / node
+  uint32_t inv_dt_q32[HU_PROFILE_MAX_NODES];                // 2^32 / dt (0: zero-length)
+  int32_t tangent_q16[HU_PROFILE_MAX_NODES][HU_AXIS_COUNT]; // Target slope, raw/ms Q16
+
+  // Cubic coefficients of the active segment (targets, Q8), rebuilt on entry
+  int32_t coef[HU_AXIS_COUNT][4];
+  bool coef_valid;
+} hu_profile_eval_t;
+
+// Precomputes all segments. Fails if count is 0 / too large or node times
+// are not non-decreasing.
+bool hu_profile_eval_load(hu_profile_eval_t *ev, const hu_profile_node_t *nodes, uint8_t count);
+
+// More nodes became available in the same array (chunked upload in
+// progress). Only the new segments and the tail tangent are recomputed; the
+// result matches a load of all count nodes. Fails, leaving ev unchanged, if
+// ev was never loaded, count is too large or the new times go backwards.
+bool hu_profile_eval_extend(hu_profile_eval_t *ev, uint8_t count);
+
+// Setpoints at t_ms from shot start. Optimised for non-decreasing t; going
+// back in time restarts the cursor.
+void hu_profile_eval_at(hu_profile_eval_t *ev, uint32_t t_ms, hu_profile_setpoint_t *out);
+
+#ifdef __cplusplus
+}
+#endif
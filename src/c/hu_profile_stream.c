@@ -0,0 +1,149 @@
+/**
+ * @file hu_profile_stream.c
+ * @brief Profile chunking and assembly
+ */
+
+#include "hu_profile_stream.h"
+
+#include <string.h>
+
+HU_STATIC_ASSERT(HU_PROFILE_CHUNK_NODES == 17, "a chunk should carry 17 nodes");
+HU_STATIC_ASSERT(HU_PROFILE_MAX_NODES <= 255, "node index is a uint8_t");
+
+uint8_t hu_profile_chunk_build(uint8_t *out, uint8_t profile_id, uint8_t upload_id, const hu_profile_node_t *nodes,
+                               uint8_t total_nodes, uint8_t index)
+{
+  size_t first = (size_t)index * HU_PROFILE_CHUNK_NODES;
+  if (first >= total_nodes)
+  {
+    return 0;
+  }
+  size_t count = total_nodes - first;
+  if (count > HU_PROFILE_CHUNK_NODES)
+  {
+    count = HU_PROFILE_CHUNK_NODES;
+  }
+
+  hu_payload_profile_chunk_t head = {profile_id, upload_id, total_nodes, (uint8_t)first};
+  memcpy(out, &head, sizeof(head));
+  memcpy(out + sizeof(head), &nodes[first], count * sizeof(hu_profile_node_t));
+  return (uint8_t)(sizeof(head) + count * sizeof(hu_profile_node_t));
+}
+
+void hu_profile_asm_init(hu_profile_asm_t *pa)
+{
+  memset(pa, 0, sizeof(*pa));
+}
+
+static bool same_upload(const hu_profile_buf_t *b, const hu_payload_profile_chunk_t *head)
+{
+  return b->chunked && b->upload_id == head->upload_id && b->profile_id == head->profile_id &&
+         b->total_nodes == head->total_nodes;
+}
+
+// Switches to the other buffer; the current one stays intact for its evaluator
+static hu_profile_buf_t *asm_start(hu_profile_asm_t *pa, uint8_t profile_id, uint8_t total_nodes)
+{
+  pa->current ^= 1;
+  hu_profile_buf_t *b = &pa->buf[pa->current];
+  b->profile_id = profile_id;
+  b->upload_id = 0;
+  b->chunked = false;
+  b->total_nodes = total_nodes;
+  b->ready_nodes = 0;
+  b->received_count = 0;
+  memset(b->received, 0, sizeof(b->received));
+  return b;
+}
+
+static hu_profile_asm_status_t asm_store(hu_profile_buf_t *b, uint8_t first, const uint8_t *src, uint8_t count)
+{
+  if ((size_t)first + count > b->total_nodes)
+  {
+    return HU_PROFILE_ASM_ERR_RANGE;
+  }
+
+  bool fresh = false;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint8_t idx = (uint8_t)(first + i);
+    uint8_t mask = (uint8_t)(1u << (idx & 7));
+    if (b->received[idx >> 3] & mask)
+    {
+      continue;
+    }
+    memcpy(&b->nodes[idx], src + (size_t)i * sizeof(hu_profile_node_t), sizeof(hu_profile_node_t));
+    b->received[idx >> 3] |= mask;
+    b->received_count++;
+    fresh = true;
+  }
+
+  // Extend the contiguous prefix; each node is passed over once per profile
+  while (b->ready_nodes < b->total_nodes &&
+         (b->received[b->ready_nodes >> 3] & (1u << (b->ready_nodes & 7))))
+  {
+    b->ready_nodes++;
+  }
+
+  if (!fresh)
+  {
+    return HU_PROFILE_ASM_DUPLICATE;
+  }
+  return b->received_count == b->total_nodes ? HU_PROFILE_ASM_COMPLETE : HU_PROFILE_ASM_PARTIAL;
+}
+
+hu_profile_asm_status_t hu_profile_asm_on_chunk(hu_profile_asm_t *pa, const uint8_t *payload, uint8_t len)
+{
+  if (len < sizeof(hu_payload_profile_chunk_t) ||
+      (len - sizeof(hu_payload_profile_chunk_t)) % sizeof(hu_profile_node_t) != 0)
+  {
+    return HU_PROFILE_ASM_ERR_SIZE;
+  }
+
+  hu_payload_profile_chunk_t head;
+  memcpy(&head, payload, sizeof(head));
+  if (head.total_nodes == 0 || head.total_nodes > HU_PROFILE_MAX_NODES)
+  {
+    return HU_PROFILE_ASM_ERR_RANGE;
+  }
+  uint8_t count = (uint8_t)((len - sizeof(head)) / sizeof(hu_profile_node_t));
+  if ((size_t)head.first_node + count > head.total_nodes)
+  {
+    return HU_PROFILE_ASM_ERR_RANGE; // Before asm_start: a bad chunk must not end the current upload
+  }
+
+  hu_profile_buf_t *b = &pa->buf[pa->current];
+  if (!same_upload(b, &head))
+  {
+    if (same_upload(&pa->buf[pa->current ^ 1], &head))
+    {
+      return HU_PROFILE_ASM_DUPLICATE; // Retransmit of the superseded upload
+    }
+    b = asm_start(pa, head.profile_id, head.total_nodes);
+    b->upload_id = head.upload_id;
+    b->chunked = true;
+  }
+  return asm_store(b, head.first_node, payload + sizeof(head), count);
+}
+
+hu_profile_asm_status_t hu_profile_asm_on_load(hu_profile_asm_t *pa, const uint8_t *payload, uint8_t len)
+{
+  if (len < sizeof(hu_payload_profile_load_t))
+  {
+    return HU_PROFILE_ASM_ERR_SIZE;
+  }
+
+  hu_payload_profile_load_t head;
+  memcpy(&head, payload, sizeof(head));
+  if ((size_t)len != sizeof(head) + (size_t)head.total_nodes * sizeof(hu_profile_node_t))
+  {
+    return HU_PROFILE_ASM_ERR_SIZE;
+  }
+  if (head.total_nodes == 0 || head.total_nodes > HU_PROFILE_MAX_NODES)
+  {
+    return HU_PROFILE_ASM_ERR_RANGE;
+  }
+
+  hu_profile_buf_t *b = asm_start(pa, head.profile_id, head.total_nodes);
+  return asm_store(b, 0, payload + sizeof(head), head.total_nodes);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file hu_profile_stream.h
+ * @brief Chunked profile transfer (CMD_PROFILE_CHUNK) and node-side assembly
+ *
+ * Sender: hu_profile_chunk_build() cuts a node array into frame-sized chunks
+ * that can all be pipelined through hu_reliable.h at once.
+ * Node: hu_profile_asm_t assembles chunks in any order into a preallocated
+ * buffer and exposes the contiguous prefix, so execution can begin after the
+ * first chunk while the rest streams in.
+ *
+ * The assembler is double-buffered: a new upload (another upload_id, or a
+ * CMD_PROFILE_LOAD) goes to the other buffer, so an evaluator still running
+ * the previous profile keeps valid nodes until the upload after that starts.
+ * Point the evaluator at the new profile once its prefix is ready:
+ *
+ *   const hu_profile_buf_t *b = hu_profile_asm_current(&pa);
+ *   if (ev.nodes != b->nodes) hu_profile_eval_load(&ev, b->nodes, b->ready_nodes);
+ *   else hu_profile_eval_extend(&ev, b->ready_nodes);
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_PROFILE_MAX_NODES 64 // Node-side buffer capacity
+#define HU_PROFILE_CHUNK_NODES \
+  ((HU_MAX_PAYLOAD_SIZE - sizeof(hu_payload_profile_chunk_t)) / sizeof(hu_profile_node_t))
+
+typedef enum
+{
+  HU_PROFILE_ASM_PARTIAL = 0,   // Chunk stored, profile incomplete
+  HU_PROFILE_ASM_COMPLETE = 1,  // All nodes present
+  HU_PROFILE_ASM_DUPLICATE = 2, // Nothing new in this chunk
+  HU_PROFILE_ASM_ERR_SIZE = 3,  // Malformed payload
+  HU_PROFILE_ASM_ERR_RANGE = 4  // Nodes outside total_nodes / buffer capacity
+} hu_profile_asm_status_t;
+
+typedef struct
+{
+  uint8_t profile_id;
+  uint8_t upload_id;
+  bool chunked;        // Came from CMD_PROFILE_CHUNK (upload_id is valid)
+  uint8_t total_nodes; // 0 = empty
+  uint8_t ready_nodes; // Contiguous nodes from index 0
+  uint8_t received_count;
+  uint8_t received[(HU_PROFILE_MAX_NODES + 7) / 8]; // Bit per node
+  hu_profile_node_t nodes[HU_PROFILE_MAX_NODES];
+} hu_profile_buf_t;
+
+typedef struct
+{
+  hu_profile_buf_t buf[2];
+  uint8_t current; // buf[] of the latest upload, the other one is the previous
+} hu_profile_asm_t;
+
+// --- Sender ---
+
+// Number of chunks needed for a profile
+static inline uint8_t hu_profile_chunk_count(uint8_t total_nodes)
+{
+  return (uint8_t)((total_nodes + HU_PROFILE_CHUNK_NODES - 1) / HU_PROFILE_CHUNK_NODES);
+}
+
+// Writes chunk `index` of a profile as a CMD_PROFILE_CHUNK payload into out
+// (at least HU_MAX_PAYLOAD_SIZE bytes). All chunks of one upload carry the
+// same upload_id; use a new one for every upload. Returns payload length, 0
+// if index is past the last chunk.
+uint8_t hu_profile_chunk_build(uint8_t *out, uint8_t profile_id, uint8_t upload_id, const hu_profile_node_t *nodes,
+                               uint8_t total_nodes, uint8_t index);
+
+// --- Node ---
+
+void hu_profile_asm_init(hu_profile_asm_t *pa);
+
+// Stores one CMD_PROFILE_CHUNK payload. Any chunk of an upload other than
+// the current one (upload_id, profile_id, total_nodes) starts a new upload in
+// the other buffer; late chunks of the previous upload are DUPLICATE.
+hu_profile_asm_status_t hu_profile_asm_on_chunk(hu_profile_asm_t *pa, const uint8_t *payload, uint8_t len);
+
+// Loads a single-frame CMD_PROFILE_LOAD as a new upload.
+hu_profile_asm_status_t hu_profile_asm_on_load(hu_profile_asm_t *pa, const uint8_t *payload, uint8_t len);
+
+// Buffer of the latest upload
+static inline const hu_profile_buf_t *hu_profile_asm_current(const hu_profile_asm_t *pa)
+{
+  return &pa->buf[pa->current];
+}
+
+static inline bool hu_profile_asm_complete(const hu_profile_asm_t *pa)
+{
+  const hu_profile_buf_t *b = hu_profile_asm_current(pa);
+  return b->total_nodes != 0 && b->ready_nodes == b->total_nodes;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,315 @@
+/**
+ * @file hu_reliable.c
+ * @brief Sliding-window sender / receiver
+ */
+
+#include "hu_reliable.h"
+#include "hu_crc.h"
+
+#include <stddef.h>
+#include <string.h>
+
+HU_STATIC_ASSERT((HU_REL_WINDOW & (HU_REL_WINDOW - 1)) == 0, "HU_REL_WINDOW must be a power of 2");
+HU_STATIC_ASSERT(HU_REL_WINDOW <= 32, "HU_REL_WINDOW must fit the 32-bit SACK bitmap");
+
+enum
+{
+  SLOT_FREE = 0,
+  SLOT_IN_FLIGHT = 1,
+  SLOT_SACKED = 2,
+  SLOT_FAST_RETX = 0x80 // Flag: already fast-retransmitted for this hole
+};
+
+#define SLOT_STATE(s) ((s)->state & 0x7F)
+
+static inline int16_t seq_diff(uint16_t a, uint16_t b)
+{
+  return (int16_t)(uint16_t)(a - b);
+}
+
+static inline hu_rel_slot_t *slot_of(hu_rel_tx_t *tx, uint16_t seq)
+{
+  return &tx->slots[seq & (HU_REL_WINDOW - 1)];
+}
+
+static uint32_t clamp_rto(uint32_t rto)
+{
+  if (rto < HU_REL_RTO_MIN_MS)
+  {
+    return HU_REL_RTO_MIN_MS;
+  }
+  return rto > HU_REL_RTO_MAX_MS ? HU_REL_RTO_MAX_MS : rto;
+}
+
+// Jacobson/Karels estimator in integer fixed point
+static void rtt_sample(hu_rel_tx_t *tx, uint32_t rtt_ms)
+{
+  if (tx->srtt_x8 == 0)
+  {
+    tx->srtt_x8 = (rtt_ms << 3) | 1u; // | 1: keep "has sample" even for 0 ms
+    tx->rttvar_x4 = rtt_ms << 1;
+  }
+  else
+  {
+    int32_t delta = (int32_t)rtt_ms - (int32_t)(tx->srtt_x8 >> 3);
+    tx->srtt_x8 = (uint32_t)((int32_t)tx->srtt_x8 + delta);
+    if (delta < 0)
+    {
+      delta = -delta;
+    }
+    delta -= (int32_t)(tx->rttvar_x4 >> 2);
+    tx->rttvar_x4 = (uint32_t)((int32_t)tx->rttvar_x4 + delta);
+  }
+  tx->rto_ms = clamp_rto((tx->srtt_x8 >> 3) + tx->rttvar_x4);
+}
+
+static bool transmit(hu_rel_tx_t *tx, hu_rel_slot_t *slot, uint32_t now_ms)
+{
+  if (slot->retries != 0 && tx->stats != NULL)
+  {
+    tx->stats->tx_retries++;
+  }
+  slot->sent_ms = now_ms;
+  return tx->send(slot->frame, slot->len, tx->send_ctx);
+}
+
+// --- Sender ---
+
+void hu_rel_tx_init(hu_rel_tx_t *tx, hu_rel_send_fn send, void *send_ctx)
+{
+  memset(tx, 0, sizeof(*tx));
+  tx->send = send;
+  tx->send_ctx = send_ctx;
+  tx->rto_ms = HU_REL_RTO_INIT_MS;
+  tx->syn = true;
+}
+
+void hu_rel_tx_reset(hu_rel_tx_t *tx)
+{
+  hu_rel_send_fn send = tx->send;
+  void *ctx = tx->send_ctx;
+  hu_stats_t *stats = tx->stats;
+  uint8_t epoch = tx->epoch;
+  hu_rel_tx_init(tx, send, ctx);
+  tx->stats = stats;
+  hu_rel_tx_set_epoch(tx, (uint8_t)(epoch + 1));
+}
+
+void hu_rel_tx_set_epoch(hu_rel_tx_t *tx, uint8_t epoch)
+{
+  tx->epoch = epoch & (HU_FLAG_EPOCH_MASK >> HU_FLAG_EPOCH_SHIFT);
+}
+
+uint8_t hu_rel_tx_free_slots(const hu_rel_tx_t *tx)
+{
+  return (uint8_t)(HU_REL_WINDOW - (uint16_t)(tx->next_seq - tx->base));
+}
+
+bool hu_rel_tx_idle(const hu_rel_tx_t *tx)
+{
+  return tx->next_seq == tx->base;
+}
+
+hu_rel_status_t hu_rel_tx_send(hu_rel_tx_t *tx, const uint8_t *frame, uint16_t len, uint32_t now_ms)
+{
+  if (tx->down)
+  {
+    return HU_REL_LINK_DOWN;
+  }
+  if (len < HU_FRAME_HEADER_SIZE || len > HU_MAX_FRAME_SIZE)
+  {
+    return HU_REL_BAD_FRAME;
+  }
+  if (hu_rel_tx_free_slots(tx) == 0)
+  {
+    return HU_REL_WINDOW_FULL;
+  }
+
+  uint16_t seq = tx->next_seq++;
+  hu_rel_slot_t *slot = slot_of(tx, seq);
+  memcpy(slot->frame, frame, len);
+  slot->len = len;
+  slot->state = SLOT_IN_FLIGHT;
+  slot->retries = 0;
+
+  hu_frame_header_t *hdr = (hu_frame_header_t *)(void *)slot->frame;
+  hdr->seq_num = seq;
+  hdr->flags = (uint8_t)((hdr->flags & ~HU_FLAG_EPOCH_MASK) | HU_FLAG_NEED_ACK | HU_FLAG_WINDOWED |
+                         (tx->epoch << HU_FLAG_EPOCH_SHIFT));
+  if (tx->syn)
+  {
+    hdr->flags |= HU_FLAG_SYN;
+    tx->syn = tx->next_seq < HU_REL_WINDOW;
+  }
+  if (hdr->flags & HU_FLAG_CRC)
+  {
+    slot->len = hu_frame_seal(slot->frame); // Header changed
+  }
+
+  return transmit(tx, slot, now_ms) ? HU_REL_OK : HU_REL_SEND_FAILED;
+}
+
+hu_rel_status_t hu_rel_tx_on_ack(hu_rel_tx_t *tx, const hu_payload_ack_t *ack, uint32_t now_ms)
+{
+  uint16_t in_flight = (uint16_t)(tx->next_seq - tx->base);
+  int16_t acked = seq_diff(ack->ack_seq, tx->base);
+  if (acked < 0 || acked > (int16_t)in_flight)
+  {
+    return HU_REL_OK; // Stale or foreign ACK
+  }
+
+  // Newest first-transmission frame acknowledged by this ACK (Karn's rule)
+  bool have_sample = false;
+  uint32_t sample_ms = 0;
+
+  // Cumulative part
+  for (uint16_t seq = tx->base; seq != ack->ack_seq; seq++)
+  {
+    hu_rel_slot_t *slot = slot_of(tx, seq);
+    if (SLOT_STATE(slot) == SLOT_IN_FLIGHT && slot->retries == 0)
+    {
+      have_sample = true;
+      sample_ms = now_ms - slot->sent_ms;
+    }
+    slot->state = SLOT_FREE;
+  }
+  tx->base = ack->ack_seq;
+
+  // Selective part: bit N = ack_seq + 1 + N
+  uint16_t highest_sacked = tx->base;
+  bool any_sacked = false;
+  for (uint8_t n = 0; n < HU_REL_WINDOW; n++)
+  {
+    if (!(ack->sack_bits & (1u << n)))
+    {
+      continue;
+    }
+    uint16_t seq = (uint16_t)(ack->ack_seq + 1 + n);
+    if (seq_diff(seq, tx->next_seq) >= 0)
+    {
+      break;
+    }
+    hu_rel_slot_t *slot = slot_of(tx, seq);
+    if (SLOT_STATE(slot) == SLOT_IN_FLIGHT)
+    {
+      if (slot->retries == 0)
+      {
+        have_sample = true;
+        sample_ms = now_ms - slot->sent_ms;
+      }
+      slot->state = SLOT_SACKED;
+    }
+    highest_sacked = seq;
+    any_sacked = true;
+  }
+
+  if (have_sample)
+  {
+    rtt_sample(tx, sample_ms);
+    hu_stats_latency(tx->stats, HU_STATS_HIST_ACK_RTT, sample_ms);
+  }
+
+  // Fast retransmit: holes below the highest SACKed frame, once per hole
+  if (any_sacked)
+  {
+    for (uint16_t seq = tx->base; seq != highest_sacked; seq++)
+    {
+      hu_rel_slot_t *slot = slot_of(tx, seq);
+      if (slot->state == SLOT_IN_FLIGHT)
+      {
+        slot->state |= SLOT_FAST_RETX;
+        slot->retries++;
+        if (!transmit(tx, slot, now_ms))
+        {
+          return HU_REL_SEND_FAILED;
+        }
+      }
+    }
+  }
+  return HU_REL_OK;
+}
+
+hu_rel_status_t hu_rel_tx_poll(hu_rel_tx_t *tx, uint32_t now_ms)
+{
+  if (tx->down)
+  {
+    return HU_REL_LINK_DOWN;
+  }
+
+  bool timed_out = false;
+  for (uint16_t seq = tx->base; seq != tx->next_seq; seq++)
+  {
+    hu_rel_slot_t *slot = slot_of(tx, seq);
+    if (SLOT_STATE(slot) != SLOT_IN_FLIGHT || now_ms - slot->sent_ms < tx->rto_ms)
+    {
+      continue;
+    }
+    if (slot->retries >= HU_REL_MAX_RETRIES)
+    {
+      tx->down = true;
+      return HU_REL_LINK_DOWN;
+    }
+    slot->retries++;
+    timed_out = true;
+    if (!transmit(tx, slot, now_ms))
+    {
+      return HU_REL_SEND_FAILED;
+    }
+  }
+
+  if (timed_out)
+  {
+    tx->rto_ms = clamp_rto(tx->rto_ms * 2); // Exponential backoff
+  }
+  return HU_REL_OK;
+}
+
+// --- Receiver ---
+
+void hu_rel_rx_init(hu_rel_rx_t *rx)
+{
+  memset(rx, 0, sizeof(*rx));
+}
+
+bool hu_rel_rx_on_frame(hu_rel_rx_t *rx, const hu_frame_header_t *hdr, hu_payload_ack_t *ack_out)
+{
+  uint8_t epoch = (uint8_t)((hdr->flags & HU_FLAG_EPOCH_MASK) >> HU_FLAG_EPOCH_SHIFT);
+  int16_t d = seq_diff(hdr->seq_num, rx->expected);
+  bool is_new = false;
+
+  // A new epoch is a restarted stream, whatever its seq_nums. Within one
+  // epoch a sender never has more than one window in flight, so anything
+  // outside [expected - W, expected + W) means a restart as well (e.g. the
+  // sender rebooted into the epoch it had before).
+  if (!rx->synced || epoch != rx->epoch || d < -HU_REL_WINDOW || d >= HU_REL_WINDOW)
+  {
+    rx->expected = (hdr->flags & HU_FLAG_SYN) ? 0 : hdr->seq_num;
+    rx->ahead = 0;
+    rx->epoch = epoch;
+    rx->synced = true;
+    d = seq_diff(hdr->seq_num, rx->expected);
+  }
+
+  if (d == 0)
+  {
+    is_new = true;
+    // Consume expected and every contiguous frame already received after it
+    bool next_present;
+    do
+    {
+      rx->expected++;
+      next_present = (rx->ahead & 1u) != 0;
+      rx->ahead >>= 1;
+    } while (next_present);
+  }
+  else if (d > 0)
+  {
+    uint32_t bit = 1u << (d - 1);
+    is_new = (rx->ahead & bit) == 0;
+    rx->ahead |= bit;
+  }
+
+  ack_out->ack_seq = rx->expected;
+  ack_out->sack_bits = rx->ahead;
+  return is_new;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file hu_reliable.h
+ * @brief Sliding-window reliable delivery over NEED_ACK / HU_MSG_ACK
+ *
+ * Up to HU_REL_WINDOW frames in flight per peer link. The receiver answers
+ * every frame with a cumulative + selective ACK (hu_payload_ack_t); the sender
+ * frees acknowledged slots, fast-retransmits holes below a SACKed frame and
+ * retransmits on an adaptive per-link timeout (RFC 6298 style, ms resolution).
+ *
+ * Windowed frames carry HU_FLAG_NEED_ACK | HU_FLAG_WINDOWED and number their
+ * seq_num per link starting at 0 (HU_FLAG_SYN marks the first window) and a
+ * 2-bit stream epoch in the flags that changes on every restart, so the
+ * receiver tells a restarted stream from retransmissions of the old one even
+ * when both use the same seq_nums. They are deduplicated by hu_rel_rx_t, not
+ * by hu_dedup_cache_t. Delivery is
+ * exactly-once but in arrival order: payloads must be self-describing
+ * (e.g. chunk offsets) if order matters.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_stats.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_REL_WINDOW 8 // Frames in flight per link (power of 2, <= 32)
+#define HU_REL_MAX_RETRIES 6
+#define HU_REL_RTO_INIT_MS 20
+#define HU_REL_RTO_MIN_MS 4
+#define HU_REL_RTO_MAX_MS 500
+
+typedef enum
+{
+  HU_REL_OK = 0,
+  HU_REL_WINDOW_FULL = 1, // No free slot: wait for ACKs / poll
+  HU_REL_BAD_FRAME = 2,   // Shorter than a header or longer than a frame
+  HU_REL_SEND_FAILED = 3, // Transport callback refused the frame
+  HU_REL_LINK_DOWN = 4    // A frame exhausted HU_REL_MAX_RETRIES; call hu_rel_tx_reset()
+} hu_rel_status_t;
+
+// Transport hook (e.g. wraps esp_now_send). Returns false if not queued.
+typedef bool (*hu_rel_send_fn)(const uint8_t *frame, uint16_t len, void *ctx);
+
+typedef struct
+{
+  uint8_t frame[HU_MAX_FRAME_SIZE]; // Kept for retransmission
+  uint16_t len;
+  uint8_t state; // Free / in flight / SACKed
+  uint8_t retries;
+  uint32_t sent_ms;
+} hu_rel_slot_t;
+
+// Sender side, one per peer link
+typedef struct
+{
+  hu_rel_slot_t slots[HU_REL_WINDOW];
+  uint16_t base;     // Oldest unacknowledged seq
+  uint16_t next_seq; // Next seq to assign
+  uint32_t srtt_x8;  // Smoothed RTT, ms * 8 (0 = no sample yet)
+  uint32_t rttvar_x4;
+  uint32_t rto_ms;
+  bool syn;      // Still inside the first window since reset
+  uint8_t epoch; // Stream epoch (0..3), stamped into HU_FLAG_EPOCH_MASK
+  bool down;
+  hu_rel_send_fn send;
+  void *send_ctx;
+  hu_stats_t *stats; // Optional: set after hu_rel_tx_init(), kept by reset
+} hu_rel_tx_t;
+
+// Receiver side, one per peer link
+typedef struct
+{
+  uint16_t expected; // Next in-order seq
+  uint32_t ahead;    // Bit N: (expected + 1 + N) already received
+  uint8_t epoch;     // Stream epoch of the sender
+  bool synced;       // epoch is valid (a frame was received since init)
+} hu_rel_rx_t;
+
+// --- Sender ---
+
+void hu_rel_tx_init(hu_rel_tx_t *tx, hu_rel_send_fn send, void *send_ctx);
+
+// Drops everything in flight and restarts the stream at seq 0 (SYN) in the
+// next epoch.
+void hu_rel_tx_reset(hu_rel_tx_t *tx);
+
+// Epoch of the first stream after boot. Seed it randomly (esp_random()) so
+// a rebooted sender is unlikely to reuse the epoch its peer saw last.
+void hu_rel_tx_set_epoch(hu_rel_tx_t *tx, uint8_t epoch);
+
+uint8_t hu_rel_tx_free_slots(const hu_rel_tx_t *tx);
+
+// True when every sent frame has been acknowledged
+bool hu_rel_tx_idle(const hu_rel_tx_t *tx);
+
+// Copies a complete frame into the window, stamps seq_num and flags, sends it.
+hu_rel_status_t hu_rel_tx_send(hu_rel_tx_t *tx, const uint8_t *frame, uint16_t len, uint32_t now_ms);
+
+// Applies an ACK received from the peer.
+hu_rel_status_t hu_rel_tx_on_ack(hu_rel_tx_t *tx, const hu_payload_ack_t *ack, uint32_t now_ms);
+
+// Retransmits timed-out frames. Call from the TX task every few ms.
+hu_rel_status_t hu_rel_tx_poll(hu_rel_tx_t *tx, uint32_t now_ms);
+
+// --- Receiver ---
+
+void hu_rel_rx_init(hu_rel_rx_t *rx);
+
+// Classifies a windowed frame and fills the ACK to send back (always, so a
+// lost ACK is repaired by the duplicate). Returns true if the frame is new.
+bool hu_rel_rx_on_frame(hu_rel_rx_t *rx, const hu_frame_header_t *hdr, hu_payload_ack_t *ack_out);
+
+#ifdef __cplusplus
+}
+#endif
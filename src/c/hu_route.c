@@ -0,0 +1,225 @@
+/**
+ * @file hu_route.c
+ * @brief Routing table and forwarding
+ */
+
+#include "hu_route.h"
+#include "hu_crc.h"
+#include "hu_frame_view.h"
+
+#include <stddef.h>
+#include <string.h>
+
+void hu_route_table_init(hu_route_table_t *rt, uint8_t self_id)
+{
+  rt->self_id = self_id;
+  rt->provisioned = false;
+  rt->generation = 0;
+  rt->group_mask = 0;
+  memset(rt->next_hop, HU_ROUTE_DIRECT, sizeof(rt->next_hop));
+}
+
+hu_route_update_result_t hu_route_apply_update(hu_route_table_t *rt, const uint8_t *payload, uint8_t len)
+{
+  if (len < sizeof(hu_payload_route_update_t) ||
+      (len - sizeof(hu_payload_route_update_t)) % sizeof(hu_route_entry_t) != 0)
+  {
+    return HU_ROUTE_UPDATE_BAD;
+  }
+
+  hu_payload_route_update_t head;
+  memcpy(&head, payload, sizeof(head));
+  if (head.mode != HU_ROUTE_UPDATE_FULL && head.mode != HU_ROUTE_UPDATE_DELTA)
+  {
+    return HU_ROUTE_UPDATE_BAD;
+  }
+
+  // FULL is a complete snapshot and always wins, whatever its generation:
+  // after an RPi restart its counter starts over. Generations order DELTAs.
+  if (head.mode == HU_ROUTE_UPDATE_DELTA)
+  {
+    if (!rt->provisioned)
+    {
+      return HU_ROUTE_UPDATE_NEED_FULL;
+    }
+    int16_t age = (int16_t)(uint16_t)(head.generation - rt->generation);
+    if (age == 0)
+    {
+      return HU_ROUTE_UPDATE_SAME;
+    }
+    if (age < 0)
+    {
+      return HU_ROUTE_UPDATE_STALE;
+    }
+    if (head.base_generation != rt->generation)
+    {
+      return HU_ROUTE_UPDATE_NEED_FULL;
+    }
+  }
+
+  if (head.mode == HU_ROUTE_UPDATE_FULL)
+  {
+    memset(rt->next_hop, HU_ROUTE_DIRECT, sizeof(rt->next_hop));
+  }
+  const uint8_t *e = payload + sizeof(head);
+  const uint8_t *end = payload + len;
+  for (; e < end; e += sizeof(hu_route_entry_t))
+  {
+    rt->next_hop[e[0]] = e[1];
+  }
+
+  rt->generation = head.generation;
+  rt->provisioned = true;
+  return HU_ROUTE_UPDATE_APPLIED;
+}
+
+bool hu_route_apply_groups(hu_route_table_t *rt, uint8_t device_type, const hu_payload_group_set_t *req)
+{
+  if (req->device_type != HU_TYPE_UNKNOWN && req->device_type != device_type)
+  {
+    return false;
+  }
+  uint16_t mask = (uint16_t)(req->group_mask & ((1u << HU_GROUP_COUNT) - 1));
+  switch (req->op)
+  {
+  case HU_GROUP_OP_SET:
+    rt->group_mask = mask;
+    return true;
+  case HU_GROUP_OP_JOIN:
+    rt->group_mask |= mask;
+    return true;
+  case HU_GROUP_OP_LEAVE:
+    rt->group_mask &= (uint16_t)~mask;
+    return true;
+  default:
+    return false;
+  }
+}
+
+hu_route_action_t hu_route_classify(const hu_route_table_t *rt, const hu_frame_header_t *hdr)
+{
+  bool via_me = hdr->via_id == rt->self_id;
+
+  if (hdr->dst_id == HU_ADDR_BROADCAST)
+  {
+    // Broadcast relayed once by the repeater named in via_id
+    return (hu_route_action_t)(HU_ROUTE_CONSUME | (via_me ? HU_ROUTE_FORWARD : 0));
+  }
+  if (hu_route_is_group(hdr->dst_id))
+  {
+    // Same as broadcast, but only members deliver; the repeater relays for
+    // members behind it whether or not it belongs to the group itself
+    uint8_t action = (rt->group_mask & HU_GROUP_BIT(hdr->dst_id)) ? HU_ROUTE_CONSUME : HU_ROUTE_DROP;
+    return (hu_route_action_t)(action | (via_me ? HU_ROUTE_FORWARD : 0));
+  }
+  if (hdr->dst_id == rt->self_id)
+  {
+    return HU_ROUTE_CONSUME;
+  }
+  // 1 hop max: only the designated repeater relays, and never back to the source
+  if (via_me && hdr->dst_id != hdr->src_id)
+  {
+    return HU_ROUTE_FORWARD;
+  }
+  return HU_ROUTE_DROP;
+}
+
+void hu_router_init(hu_router_t *r, const hu_route_table_t *table, hu_dedup_cache_t *dedup, hu_route_send_fn send,
+                    void *ctx)
+{
+  memset(r, 0, sizeof(*r));
+  r->table = table;
+  r->dedup = dedup;
+  r->send = send;
+  r->ctx = ctx;
+}
+
+static uint8_t route_rx(hu_router_t *r, uint8_t *frame, uint16_t len, bool timed, uint32_t rx_ms, uint32_t now_ms)
+{
+  if (len < HU_FRAME_HEADER_SIZE)
+  {
+    r->dropped++;
+    return HU_ROUTE_DROP;
+  }
+  hu_frame_header_t *hdr = (hu_frame_header_t *)(void *)frame;
+
+  uint8_t action = hu_route_classify(r->table, hdr);
+  if (action == HU_ROUTE_DROP)
+  {
+    r->dropped++;
+    return HU_ROUTE_DROP;
+  }
+
+  // A malformed or corrupted frame must neither mark its seq_num as seen nor
+  // be re-sealed and passed on by the forward below
+  hu_frame_view_t view;
+  hu_frame_status_t status = hu_frame_view_init(&view, frame, len);
+  if (status == HU_FRAME_OK &&
+      len != view.frame_len + ((hdr->flags & HU_FLAG_CRC) ? HU_FRAME_CRC_SIZE : 0))
+  {
+    status = HU_FRAME_ERR_TRUNCATED; // Trailing bytes would be forwarded too
+  }
+  if (status != HU_FRAME_OK)
+  {
+    r->dropped++;
+    if (r->stats != NULL)
+    {
+      r->stats->rx_bad++;
+      r->stats->rx_bad_crc += status == HU_FRAME_ERR_CRC;
+    }
+    return HU_ROUTE_DROP;
+  }
+
+  // Windowed streams number per link and are deduplicated end to end
+  if (r->dedup != NULL && !(hdr->flags & HU_FLAG_WINDOWED) &&
+      hu_dedup_check_and_set(r->dedup, hdr->src_id, hdr->seq_num) == HU_DEDUP_DUPLICATE)
+  {
+    r->dropped++;
+    if (r->stats != NULL)
+    {
+      r->stats->rx_duplicates++;
+    }
+    return HU_ROUTE_DROP;
+  }
+
+  if (action & HU_ROUTE_FORWARD)
+  {
+    // Last hop is always direct: only via_id changes
+    hdr->via_id = HU_ROUTE_DIRECT;
+    if (hdr->flags & HU_FLAG_CRC)
+    {
+      hu_frame_seal(frame);
+    }
+    if (r->send(hdr->dst_id, frame, len, r->ctx))
+    {
+      r->forwarded++;
+      if (r->stats != NULL)
+      {
+        r->stats->forwarded++;
+        if (timed)
+        {
+          hu_stats_latency(r->stats, HU_STATS_HIST_FORWARD, now_ms - rx_ms);
+        }
+      }
+    }
+    else
+    {
+      r->forward_failed++;
+      if (r->stats != NULL)
+      {
+        r->stats->forward_failed++;
+      }
+    }
+  }
+  return action;
+}
+
+uint8_t hu_route_rx(hu_router_t *r, uint8_t *frame, uint16_t len)
+{
+  return route_rx(r, frame, len, false, 0, 0);
+}
+
+uint8_t hu_route_rx_timed(hu_router_t *r, uint8_t *frame, uint16_t len, uint32_t rx_ms, uint32_t now_ms)
+{
+  return route_rx(r, frame, len, true, rx_ms, now_ms);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file hu_route.h
+ * @brief Static routing table and O(1) repeater fast path (docs/routing.md)
+ *
+ * hu_route_rx() decides forward / consume / drop from dst_id and via_id alone.
+ * Forwarding rewrites via_id in the frame bytes and hands the buffer straight
+ * to the transport hook, so repeated traffic never reaches the application
+ * task. The buffer must be writable (RX ring slot or a copy of the ESP-NOW
+ * callback data).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_dedup.h"
+#include "hu_stats.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_ROUTE_DIRECT 0x00 // routing_table value / via_id: no repeater
+
+typedef struct
+{
+  uint8_t self_id;
+  bool provisioned;      // A FULL update has been applied
+  uint16_t generation;   // Of the last applied update
+  uint16_t group_mask;   // HU_GROUP_BIT() of every group this node belongs to
+  uint8_t next_hop[256]; // next_hop[target] = repeater id, HU_ROUTE_DIRECT = direct
+} hu_route_table_t;
+
+typedef enum
+{
+  HU_ROUTE_UPDATE_APPLIED = 0,
+  HU_ROUTE_UPDATE_SAME = 1,      // DELTA already at this generation (retransmit): ACK again
+  HU_ROUTE_UPDATE_STALE = 2,     // DELTA of an older generation: ignore
+  HU_ROUTE_UPDATE_NEED_FULL = 3, // Delta base mismatch: reply HU_ERR_ROUTE_GENERATION
+  HU_ROUTE_UPDATE_BAD = 4        // Malformed payload
+} hu_route_update_result_t;
+
+// Action bits
+typedef enum
+{
+  HU_ROUTE_DROP = 0x00,    // Overheard / duplicate
+  HU_ROUTE_CONSUME = 0x01, // Deliver to the application
+  HU_ROUTE_FORWARD = 0x02  // Retransmit (done by hu_route_rx)
+} hu_route_action_t;
+
+// Transport hook: transmit `frame` to logical node `to_id` (map to MAC;
+// broadcast and group ids map to the broadcast MAC).
+typedef bool (*hu_route_send_fn)(uint8_t to_id, const uint8_t *frame, uint16_t len, void *ctx);
+
+typedef struct
+{
+  const hu_route_table_t *table;
+  hu_dedup_cache_t *dedup; // Optional: drop duplicates before forwarding
+  hu_route_send_fn send;
+  void *ctx;
+  hu_stats_t *stats; // Optional: set after hu_router_init()
+  uint32_t forwarded;
+  uint32_t forward_failed;
+  uint32_t dropped;
+} hu_router_t;
+
+// Every target direct, self_id = HU_ADDR_UNASSIGNED
+void hu_route_table_init(hu_route_table_t *rt, uint8_t self_id);
+
+// Applies a SYS_ROUTE_UPDATE payload (sparse FULL table or DELTA). A FULL
+// replaces the table and adopts its generation unconditionally; a DELTA
+// applies only on top of base_generation.
+hu_route_update_result_t hu_route_apply_update(hu_route_table_t *rt, const uint8_t *payload, uint8_t len);
+
+// Applies a SYS_GROUP_SET payload for a node of type device_type. Returns
+// false if it is not meant for this device type (membership unchanged).
+bool hu_route_apply_groups(hu_route_table_t *rt, uint8_t device_type, const hu_payload_group_set_t *req);
+
+static inline bool hu_route_is_group(uint8_t addr)
+{
+  return addr >= HU_ADDR_MIN_GROUP && addr <= HU_ADDR_MAX_GROUP;
+}
+
+// Membership check for the RX path: one compare and one bit test
+static inline bool hu_route_in_group(const hu_route_table_t *rt, uint8_t addr)
+{
+  return hu_route_is_group(addr) && (rt->group_mask & HU_GROUP_BIT(addr));
+}
+
+// via_id to stamp on an outgoing frame for dst_id
+static inline uint8_t hu_route_via(const hu_route_table_t *rt, uint8_t dst_id)
+{
+  return rt->next_hop[dst_id];
+}
+
+// Transmits to this id for dst_id (the repeater, or dst_id itself)
+static inline uint8_t hu_route_next_hop(const hu_route_table_t *rt, uint8_t dst_id)
+{
+  uint8_t via = rt->next_hop[dst_id];
+  return via == HU_ROUTE_DIRECT ? dst_id : via;
+}
+
+// Header-only decision, no side effects
+hu_route_action_t hu_route_classify(const hu_route_table_t *rt, const hu_frame_header_t *hdr);
+
+void hu_router_init(hu_router_t *r, const hu_route_table_t *table, hu_dedup_cache_t *dedup, hu_route_send_fn send,
+                    void *ctx);
+
+// RX fast path. Forwards in place if needed and returns the action bits;
+// the caller passes the frame on only if HU_ROUTE_CONSUME is set. Frames not
+// for this node are dropped first; the rest must pass hu_frame_view_init()
+// and be exactly header + payload (+ CRC) long, or are dropped as rx_bad.
+// With a dedup cache, a non-windowed duplicate returns HU_ROUTE_DROP; that
+// check covers consumed frames too, so do not run the same cache again.
+uint8_t hu_route_rx(hu_router_t *r, uint8_t *frame, uint16_t len);
+
+// hu_route_rx() that also records the forwarding delay (rx_ms: RX ring slot
+// time, now_ms: current time) in HU_STATS_HIST_FORWARD.
+uint8_t hu_route_rx_timed(hu_router_t *r, uint8_t *frame, uint16_t len, uint32_t rx_ms, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
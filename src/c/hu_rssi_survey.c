@@ -0,0 +1,110 @@
+/**
+ * @file hu_rssi_survey.c
+ * @brief Self-timed roll call and neighbour vector accumulation
+ */
+
+#include "hu_rssi_survey.h"
+
+#include <string.h>
+
+HU_STATIC_ASSERT(sizeof(hu_payload_rssi_report_t) + HU_RSSI_MAX_PROBES * sizeof(hu_rssi_entry_t) <=
+                     HU_MAX_PAYLOAD_SIZE,
+                 "a full neighbour vector must fit one frame");
+
+void hu_rssi_survey_init(hu_rssi_survey_t *s)
+{
+  memset(s, 0, sizeof(*s));
+}
+
+bool hu_rssi_survey_start(hu_rssi_survey_t *s, const uint8_t *payload, uint8_t len, uint8_t self_id,
+                          uint32_t now_ms)
+{
+  hu_rssi_survey_init(s);
+  if (len < sizeof(hu_payload_rssi_survey_t) || len - sizeof(hu_payload_rssi_survey_t) > HU_RSSI_MAX_PROBES)
+  {
+    return false;
+  }
+
+  hu_payload_rssi_survey_t head;
+  memcpy(&head, payload, sizeof(head));
+  uint8_t count = (uint8_t)(len - sizeof(head));
+  memcpy(s->probes, payload + sizeof(head), count);
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (s->probes[i] == self_id)
+    {
+      s->active = true;
+      s->session = head.session;
+      s->slot_ms = head.slot_ms;
+      s->probe_count = count;
+      s->my_index = i;
+      s->start_ms = now_ms;
+      return true;
+    }
+  }
+  return false;
+}
+
+void hu_rssi_survey_on_frame(hu_rssi_survey_t *s, uint8_t src_id, int8_t rssi_dbm)
+{
+  if (!s->active)
+  {
+    return;
+  }
+  for (uint8_t i = 0; i < s->probe_count; i++)
+  {
+    if (s->probes[i] == src_id)
+    {
+      if (i != s->my_index && s->samples[i] < UINT8_MAX)
+      {
+        s->rssi_sum[i] = (int16_t)(s->rssi_sum[i] + rssi_dbm);
+        s->samples[i]++;
+      }
+      return;
+    }
+  }
+}
+
+hu_rssi_survey_action_t hu_rssi_survey_poll(hu_rssi_survey_t *s, uint32_t now_ms)
+{
+  if (!s->active)
+  {
+    return HU_RSSI_SURVEY_IDLE;
+  }
+  uint32_t elapsed = now_ms - s->start_ms;
+  if (!s->pinged && elapsed >= (uint32_t)s->my_index * s->slot_ms)
+  {
+    s->pinged = true;
+    return HU_RSSI_SURVEY_SEND_PING;
+  }
+  if (elapsed >= (uint32_t)(s->probe_count + s->my_index) * s->slot_ms)
+  {
+    s->active = false; // Counters stay valid for build_report
+    return HU_RSSI_SURVEY_SEND_REPORT;
+  }
+  return HU_RSSI_SURVEY_WAIT;
+}
+
+uint8_t hu_rssi_survey_build_report(const hu_rssi_survey_t *s, uint8_t *out)
+{
+  hu_payload_rssi_report_t head = {s->session};
+  memcpy(out, &head, sizeof(head));
+  uint8_t len = sizeof(head);
+
+  for (uint8_t i = 0; i < s->probe_count; i++)
+  {
+    if (i == s->my_index)
+    {
+      continue;
+    }
+    hu_rssi_entry_t e = {s->probes[i], 0, s->samples[i]};
+    if (s->samples[i] != 0)
+    {
+      e.rssi_dbm = (int8_t)(s->rssi_sum[i] / s->samples[i]);
+    }
+    memcpy(out + len, &e, sizeof(e));
+    len = (uint8_t)(len + sizeof(e));
+  }
+  return len;
+}
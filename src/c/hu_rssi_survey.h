@@ -0,0 +1,70 @@
+/**
+ * @file hu_rssi_survey.h
+ * @brief Node side of the bulk RSSI survey (SYS_RSSI_SURVEY / SYS_RSSI_REPORT)
+ *
+ * One broadcast request schedules the whole roll call: every listed node
+ * pings in its own slot, hears everyone else's ping, and at the end returns
+ * its complete neighbour vector in a single report. N nodes cost 2N + 1
+ * frames instead of one request and N - 1 reports per ping.
+ *
+ * Usage: hu_rssi_survey_start() on the request, hu_rssi_survey_on_frame()
+ * for each received frame (with ESP-NOW rx_ctrl->rssi), hu_rssi_survey_poll()
+ * from the main loop.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_RSSI_MAX_PROBES 64 // Node-side capacity (report fits 76 entries)
+
+typedef enum
+{
+  HU_RSSI_SURVEY_IDLE = 0,
+  HU_RSSI_SURVEY_SEND_PING = 1,   // Broadcast HU_MSG_PING now
+  HU_RSSI_SURVEY_SEND_REPORT = 2, // Send hu_rssi_survey_build_report() to the coordinator
+  HU_RSSI_SURVEY_WAIT = 3         // Survey running, nothing to do yet
+} hu_rssi_survey_action_t;
+
+typedef struct
+{
+  bool active;
+  bool pinged;
+  uint8_t session;
+  uint8_t slot_ms;
+  uint8_t probe_count;
+  uint8_t my_index;
+  uint32_t start_ms;
+  uint8_t probes[HU_RSSI_MAX_PROBES];
+  int16_t rssi_sum[HU_RSSI_MAX_PROBES];
+  uint8_t samples[HU_RSSI_MAX_PROBES];
+} hu_rssi_survey_t;
+
+void hu_rssi_survey_init(hu_rssi_survey_t *s);
+
+// Starts a survey from a SYS_RSSI_SURVEY payload. Returns false if self_id is
+// not listed (node stays passive) or the list exceeds HU_RSSI_MAX_PROBES.
+bool hu_rssi_survey_start(hu_rssi_survey_t *s, const uint8_t *payload, uint8_t len, uint8_t self_id,
+                          uint32_t now_ms);
+
+// Accumulates rssi of any frame from a listed node while the survey runs.
+void hu_rssi_survey_on_frame(hu_rssi_survey_t *s, uint8_t src_id, int8_t rssi_dbm);
+
+// Each action is returned once; the survey ends after SEND_REPORT.
+hu_rssi_survey_action_t hu_rssi_survey_poll(hu_rssi_survey_t *s, uint32_t now_ms);
+
+// Writes the SYS_RSSI_REPORT payload (one entry per other probe) into out
+// (at least HU_MAX_PAYLOAD_SIZE bytes). Returns payload length.
+uint8_t hu_rssi_survey_build_report(const hu_rssi_survey_t *s, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file hu_rx_ring.c
+ * @brief SPSC ring: acquire/release index handoff
+ */
+
+#include "hu_rx_ring.h"
+
+#include <string.h>
+
+HU_STATIC_ASSERT((HU_RX_RING_SLOTS & (HU_RX_RING_SLOTS - 1)) == 0, "HU_RX_RING_SLOTS must be a power of two");
+
+#define SLOT(r, i) (&(r)->slots[(i) & (HU_RX_RING_SLOTS - 1)])
+
+void hu_rx_ring_init(hu_rx_ring_t *r)
+{
+  memset(r, 0, sizeof(*r));
+}
+
+hu_rx_slot_t *hu_rx_ring_reserve(hu_rx_ring_t *r)
+{
+  uint32_t head = r->head; // Own index: plain read
+  uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+  if (head - tail >= HU_RX_RING_SLOTS)
+  {
+    r->overflow++;
+    return NULL;
+  }
+  return SLOT(r, head);
+}
+
+void hu_rx_ring_commit(hu_rx_ring_t *r)
+{
+  uint32_t head = r->head + 1;
+  uint32_t depth = head - __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+  if (depth > r->high_water)
+  {
+    r->high_water = depth;
+  }
+  r->received++;
+  // Slot contents become visible before the new head
+  __atomic_store_n(&r->head, head, __ATOMIC_RELEASE);
+}
+
+bool hu_rx_ring_push(hu_rx_ring_t *r, const uint8_t *data, uint16_t len, int8_t rssi_dbm, uint32_t rx_ms)
+{
+  if (len > HU_MAX_FRAME_SIZE)
+  {
+    r->too_long++;
+    return false;
+  }
+  hu_rx_slot_t *slot = hu_rx_ring_reserve(r);
+  if (slot == NULL)
+  {
+    return false;
+  }
+  memcpy(slot->frame, data, len);
+  slot->len = len;
+  slot->rssi_dbm = rssi_dbm;
+  slot->rx_ms = rx_ms;
+  hu_rx_ring_commit(r);
+  return true;
+}
+
+hu_rx_slot_t *hu_rx_ring_peek(hu_rx_ring_t *r)
+{
+  uint32_t tail = r->tail;
+  if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail)
+  {
+    return NULL;
+  }
+  return SLOT(r, tail);
+}
+
+void hu_rx_ring_release(hu_rx_ring_t *r)
+{
+  // Done with the slot before the producer may reuse it
+  __atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t hu_rx_ring_count(const hu_rx_ring_t *r)
+{
+  return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+}
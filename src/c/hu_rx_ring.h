@@ -0,0 +1,76 @@
+/**
+ * @file hu_rx_ring.h
+ * @brief Lock-free SPSC RX ring over a static frame pool
+ *
+ * Producer: the ESP-NOW receive callback (WiFi task). Consumer: the
+ * application / protocol task. Frames are copied once from the driver buffer
+ * into a preallocated slot; the consumer validates, routes (hu_route_rx needs
+ * a writable buffer) and dispatches straight from the slot, then releases it.
+ * No allocation, no locks, fixed memory: HU_RX_RING_SLOTS * sizeof(hu_rx_slot_t).
+ *
+ * Exactly one producer and one consumer context. Indices are published with
+ * acquire/release ordering (GCC __atomic builtins, also in ESP-IDF).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef HU_RX_RING_SLOTS
+#define HU_RX_RING_SLOTS 16 // Power of two
+#endif
+
+typedef struct
+{
+  uint16_t len;
+  int8_t rssi_dbm;  // rx_ctrl->rssi
+  uint8_t reserved;
+  uint32_t rx_ms;   // Local receive time
+  uint8_t frame[HU_MAX_FRAME_SIZE];
+} hu_rx_slot_t;
+
+typedef struct
+{
+  uint32_t head; // Written by the producer only
+  uint32_t tail; // Written by the consumer only
+  hu_rx_slot_t slots[HU_RX_RING_SLOTS];
+
+  // Producer-side counters
+  uint32_t received;
+  uint32_t overflow; // Ring full: frame dropped
+  uint32_t too_long; // Larger than HU_MAX_FRAME_SIZE: frame dropped
+  uint32_t high_water;
+} hu_rx_ring_t;
+
+void hu_rx_ring_init(hu_rx_ring_t *r);
+
+// --- Producer (RX callback) ---
+
+// Free slot to fill, NULL if full (counted as overflow). Set len, then
+// hu_rx_ring_commit().
+hu_rx_slot_t *hu_rx_ring_reserve(hu_rx_ring_t *r);
+void hu_rx_ring_commit(hu_rx_ring_t *r);
+
+// reserve + copy + commit. Returns false if the frame was dropped.
+bool hu_rx_ring_push(hu_rx_ring_t *r, const uint8_t *data, uint16_t len, int8_t rssi_dbm, uint32_t rx_ms);
+
+// --- Consumer (application task) ---
+
+// Oldest frame, NULL if empty. Valid and writable until hu_rx_ring_release().
+hu_rx_slot_t *hu_rx_ring_peek(hu_rx_ring_t *r);
+void hu_rx_ring_release(hu_rx_ring_t *r);
+
+// Frames waiting (approximate when called from the other side)
+uint32_t hu_rx_ring_count(const hu_rx_ring_t *r);
+
+#ifdef __cplusplus
+}
+#endif
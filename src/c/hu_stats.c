@@ -0,0 +1,111 @@
+/**
+ * @file hu_stats.c
+ * @brief Statistics snapshot and per-link RSSI tracking
+ */
+
+#include "hu_stats.h"
+
+#include <string.h>
+
+HU_STATIC_ASSERT(sizeof(hu_payload_stats_t) + HU_STATS_MAX_LINKS * sizeof(hu_stats_link_t) <= HU_MAX_PAYLOAD_SIZE,
+                 "DATA_STATS must fit one frame");
+
+void hu_stats_init(hu_stats_t *st, uint32_t now_ms)
+{
+  memset(st, 0, sizeof(*st));
+  st->reset_ms = now_ms;
+}
+
+void hu_stats_reset_interval(hu_stats_t *st, uint32_t now_ms)
+{
+  memset(st->hist, 0, sizeof(st->hist));
+  st->link_count = 0;
+  st->reset_ms = now_ms;
+}
+
+void hu_stats_link_rx(hu_stats_t *st, uint8_t peer_id, int8_t rssi_dbm)
+{
+  if (st == NULL)
+  {
+    return;
+  }
+  hu_stats_link_state_t *l = NULL;
+  for (uint8_t i = 0; i < st->link_count; i++)
+  {
+    if (st->links[i].peer_id == peer_id)
+    {
+      l = &st->links[i];
+      break;
+    }
+  }
+  if (l == NULL)
+  {
+    if (st->link_count >= HU_STATS_MAX_LINKS)
+    {
+      return;
+    }
+    l = &st->links[st->link_count++];
+    l->peer_id = peer_id;
+    l->rssi_min_dbm = rssi_dbm;
+    l->rssi_avg_x16 = (int16_t)(rssi_dbm * 16);
+    l->frames = 0;
+  }
+  l->frames++;
+  l->rssi_min_dbm = rssi_dbm < l->rssi_min_dbm ? rssi_dbm : l->rssi_min_dbm;
+  l->rssi_avg_x16 = (int16_t)(l->rssi_avg_x16 + (rssi_dbm * 16 - l->rssi_avg_x16) / 8);
+}
+
+static uint16_t sat16(uint32_t v)
+{
+  return v > UINT16_MAX ? UINT16_MAX : (uint16_t)v;
+}
+
+uint8_t hu_stats_build(const hu_stats_t *st, uint32_t now_ms, uint8_t *out)
+{
+  hu_payload_stats_t head;
+  head.uptime_ms = now_ms;
+  head.interval_ms = now_ms - st->reset_ms;
+  head.rx_frames = st->rx_frames;
+  head.rx_bad = st->rx_bad;
+  head.rx_bad_crc = st->rx_bad_crc;
+  head.rx_duplicates = st->rx_duplicates;
+  head.rx_overflow = st->rx_overflow;
+  head.forwarded = st->forwarded;
+  head.forward_failed = st->forward_failed;
+  head.tx_frames = st->tx_frames;
+  head.tx_retries = st->tx_retries;
+  head.tx_dropped = st->tx_dropped;
+  for (int h = 0; h < HU_STATS_HIST_COUNT; h++)
+  {
+    for (int b = 0; b < HU_STATS_HIST_BUCKETS; b++)
+    {
+      head.hist[h][b] = sat16(st->hist[h][b]);
+    }
+  }
+  memcpy(out, &head, sizeof(head));
+
+  uint8_t len = sizeof(head);
+  for (uint8_t i = 0; i < st->link_count; i++)
+  {
+    const hu_stats_link_state_t *l = &st->links[i];
+    hu_stats_link_t entry = {
+        .peer_id = l->peer_id,
+        .rssi_avg_dbm = (int8_t)(l->rssi_avg_x16 / 16),
+        .rssi_min_dbm = l->rssi_min_dbm,
+        .frames = sat16(l->frames),
+    };
+    memcpy(out + len, &entry, sizeof(entry));
+    len += sizeof(entry);
+  }
+  return len;
+}
+
+uint8_t hu_stats_on_request(hu_stats_t *st, const hu_payload_stats_req_t *req, uint32_t now_ms, uint8_t *out)
+{
+  uint8_t len = hu_stats_build(st, now_ms, out);
+  if (req->flags & HU_STATS_REQ_RESET)
+  {
+    hu_stats_reset_interval(st, now_ms);
+  }
+  return len;
+}
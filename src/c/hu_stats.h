@@ -0,0 +1,109 @@
+/**
+ * @file hu_stats.h
+ * @brief On-node link and hot-path statistics (SYS_STATS_REQ / DATA_STATS)
+ *
+ * One hu_stats_t per node. The router, TX scheduler and reliable sender take
+ * an optional pointer to it (NULL = no statistics) and bump plain counters;
+ * latencies go into log2 ms histograms, one increment and a count of
+ * leading zeros per sample. The application counts frame view results and
+ * per-link RSSI from the RX ring slots.
+ *
+ * The gateway pulls a snapshot with SYS_STATS_REQ; the node answers with
+ * DATA_STATS built by hu_stats_build().
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_frame_view.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_STATS_MAX_LINKS 8 // Previous hops tracked per interval
+
+typedef struct
+{
+  uint8_t peer_id;
+  int8_t rssi_min_dbm;
+  int16_t rssi_avg_x16; // EWMA (1/8), dBm * 16
+  uint32_t frames;
+} hu_stats_link_state_t;
+
+typedef struct
+{
+  uint32_t reset_ms; // Start of the interval
+  uint32_t rx_frames;
+  uint32_t rx_bad;
+  uint32_t rx_bad_crc;
+  uint32_t rx_duplicates;
+  uint32_t rx_overflow; // Copy of hu_rx_ring_t.overflow (written by the RX callback)
+  uint32_t forwarded;
+  uint32_t forward_failed;
+  uint32_t tx_frames;
+  uint32_t tx_retries;
+  uint32_t tx_dropped;
+  uint32_t hist[HU_STATS_HIST_COUNT][HU_STATS_HIST_BUCKETS];
+  uint8_t link_count;
+  hu_stats_link_state_t links[HU_STATS_MAX_LINKS];
+} hu_stats_t;
+
+void hu_stats_init(hu_stats_t *st, uint32_t now_ms);
+
+// Clears histograms and links, counters keep running.
+void hu_stats_reset_interval(hu_stats_t *st, uint32_t now_ms);
+
+static inline uint8_t hu_stats_bucket(uint32_t ms)
+{
+  if (ms == 0)
+  {
+    return 0;
+  }
+  uint8_t b = (uint8_t)(32 - __builtin_clz(ms)); // 1 -> 1, 2..3 -> 2, 4..7 -> 3
+  return b < HU_STATS_HIST_BUCKETS ? b : HU_STATS_HIST_BUCKETS - 1;
+}
+
+static inline void hu_stats_latency(hu_stats_t *st, hu_stats_hist_id_t id, uint32_t ms)
+{
+  if (st != NULL)
+  {
+    st->hist[id][hu_stats_bucket(ms)]++;
+  }
+}
+
+// Result of hu_frame_view_init() for a received frame
+static inline void hu_stats_frame(hu_stats_t *st, hu_frame_status_t status)
+{
+  if (st == NULL)
+  {
+    return;
+  }
+  if (status == HU_FRAME_OK)
+  {
+    st->rx_frames++;
+    return;
+  }
+  st->rx_bad++;
+  st->rx_bad_crc += status == HU_FRAME_ERR_CRC;
+}
+
+// A frame from previous hop peer_id (mapped from the sender MAC). A new
+// peer beyond HU_STATS_MAX_LINKS is not tracked until the next interval.
+void hu_stats_link_rx(hu_stats_t *st, uint8_t peer_id, int8_t rssi_dbm);
+
+// Writes a DATA_STATS payload (at least HU_MAX_PAYLOAD_SIZE bytes) and
+// returns its length.
+uint8_t hu_stats_build(const hu_stats_t *st, uint32_t now_ms, uint8_t *out);
+
+// Answers a SYS_STATS_REQ: snapshot into out, then a new interval if the
+// request asks for it. Returns the DATA_STATS payload length.
+uint8_t hu_stats_on_request(hu_stats_t *st, const hu_payload_stats_req_t *req, uint32_t now_ms, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
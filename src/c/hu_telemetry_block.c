@@ -0,0 +1,157 @@
+/**
+ * @file hu_telemetry_block.c
+ * @brief Zigzag varint block codec
+ */
+
+#include "hu_telemetry_block.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define VARINT_MAX 5 // uint32_t in LEB128
+
+static inline uint32_t zigzag(int32_t v)
+{
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v)
+{
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static uint8_t put_varint(uint8_t *out, uint32_t v)
+{
+  uint8_t n = 0;
+  while (v >= 0x80)
+  {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static bool get_varint(const uint8_t **pos, const uint8_t *end, uint32_t *v)
+{
+  uint32_t r = 0;
+  for (uint8_t shift = 0; shift < 7 * VARINT_MAX && *pos < end; shift += 7)
+  {
+    uint8_t byte = *(*pos)++;
+    r |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      *v = r;
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline hu_payload_data_block_t *block_head(hu_block_enc_t *enc)
+{
+  return (hu_payload_data_block_t *)(void *)enc->buf;
+}
+
+// --- Encoder ---
+
+void hu_block_begin(hu_block_enc_t *enc, uint8_t source_type, uint8_t channel, uint16_t interval_ms,
+                    bool has_b, const hu_block_sample_t *first)
+{
+  hu_payload_data_block_t *h = block_head(enc);
+  memset(h, 0, sizeof(*h));
+  h->source_type = source_type;
+  h->channel = channel;
+  h->flags = has_b ? HU_BLOCK_HAS_B : 0;
+  h->sample_count = 1;
+  h->interval_ms = interval_ms;
+  h->base_timestamp_ms = first->timestamp_ms;
+  h->base_a = first->a;
+  h->base_b = has_b ? first->b : 0;
+
+  enc->len = sizeof(*h);
+  enc->last_a = first->a;
+  enc->last_b = h->base_b;
+}
+
+bool hu_block_append(hu_block_enc_t *enc, int32_t a, int32_t b)
+{
+  hu_payload_data_block_t *h = block_head(enc);
+  bool has_b = (h->flags & HU_BLOCK_HAS_B) != 0;
+  if (h->sample_count == UINT8_MAX)
+  {
+    return false;
+  }
+
+  uint8_t tmp[2 * VARINT_MAX];
+  uint8_t n = put_varint(tmp, zigzag((int32_t)((uint32_t)a - (uint32_t)enc->last_a)));
+  if (has_b)
+  {
+    n = (uint8_t)(n + put_varint(tmp + n, zigzag((int32_t)((uint32_t)b - (uint32_t)enc->last_b))));
+  }
+  if (enc->len + n > HU_MAX_PAYLOAD_SIZE)
+  {
+    return false;
+  }
+
+  memcpy(enc->buf + enc->len, tmp, n);
+  enc->len = (uint8_t)(enc->len + n);
+  enc->last_a = a;
+  enc->last_b = has_b ? b : 0;
+  h->sample_count++;
+  return true;
+}
+
+void hu_block_set_status(hu_block_enc_t *enc, uint8_t status)
+{
+  block_head(enc)->status = status;
+}
+
+// --- Decoder ---
+
+bool hu_block_iter_init(hu_block_iter_t *it, const uint8_t *payload, uint8_t len)
+{
+  if (len < sizeof(hu_payload_data_block_t))
+  {
+    return false;
+  }
+  memcpy(&it->head, payload, sizeof(it->head));
+  it->pos = payload + sizeof(it->head);
+  it->end = payload + len;
+  it->index = 0;
+  it->current.timestamp_ms = it->head.base_timestamp_ms;
+  it->current.a = it->head.base_a;
+  it->current.b = it->head.base_b;
+  return true;
+}
+
+bool hu_block_next(hu_block_iter_t *it, hu_block_sample_t *out)
+{
+  if (it->index >= it->head.sample_count)
+  {
+    return false;
+  }
+
+  if (it->index > 0)
+  {
+    uint32_t d;
+    if (!get_varint(&it->pos, it->end, &d))
+    {
+      return false;
+    }
+    it->current.a = (int32_t)((uint32_t)it->current.a + (uint32_t)unzigzag(d));
+    if (it->head.flags & HU_BLOCK_HAS_B)
+    {
+      if (!get_varint(&it->pos, it->end, &d))
+      {
+        return false;
+      }
+      it->current.b = (int32_t)((uint32_t)it->current.b + (uint32_t)unzigzag(d));
+    }
+    it->current.timestamp_ms += it->head.interval_ms;
+  }
+
+  it->index++;
+  *out = it->current;
+  return true;
+}
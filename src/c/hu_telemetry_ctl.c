@@ -0,0 +1,226 @@
+/**
+ * @file hu_telemetry_ctl.c
+ * @brief Telemetry subscriptions: decimation, windowed aggregation, report-on-delta
+ */
+
+#include "hu_telemetry_ctl.h"
+
+#include <string.h>
+
+void hu_telemetry_ctl_init(hu_telemetry_ctl_t *tc)
+{
+  memset(tc, 0, sizeof(*tc));
+}
+
+static hu_telemetry_stream_t *find_in(hu_telemetry_stream_t *pool, uint8_t count, uint8_t source_type,
+                                      uint8_t channel)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    hu_telemetry_stream_t *s = &pool[i];
+    if (s->cfg.source_type == source_type && s->cfg.channel == channel)
+    {
+      return s;
+    }
+  }
+  return NULL;
+}
+
+static hu_telemetry_stream_t *find(hu_telemetry_ctl_t *tc, uint8_t source_type, uint8_t channel)
+{
+  return find_in(tc->streams, tc->count, source_type, channel);
+}
+
+// Removes the streams of a source (one channel, or all of them)
+static void drop(hu_telemetry_stream_t *pool, uint8_t *count, uint8_t source_type, uint8_t channel)
+{
+  uint8_t keep = 0;
+  for (uint8_t i = 0; i < *count; i++)
+  {
+    const hu_payload_telemetry_cfg_t *c = &pool[i].cfg;
+    if (c->source_type != source_type || (channel != HU_TELEMETRY_ALL_CHANNELS && c->channel != channel))
+    {
+      pool[keep++] = pool[i];
+    }
+  }
+  *count = keep;
+}
+
+static void stream_reset(hu_telemetry_stream_t *s, const hu_payload_telemetry_cfg_t *cfg)
+{
+  memset(s, 0, sizeof(*s));
+  s->cfg = *cfg;
+}
+
+static hu_telemetry_stream_t *add(hu_telemetry_ctl_t *tc, const hu_payload_telemetry_cfg_t *cfg)
+{
+  if (tc->count >= HU_TELEMETRY_MAX_STREAMS)
+  {
+    return NULL;
+  }
+  hu_telemetry_stream_t *s = &tc->streams[tc->count++];
+  stream_reset(s, cfg);
+  return s;
+}
+
+hu_telemetry_cfg_result_t hu_telemetry_ctl_apply(hu_telemetry_ctl_t *tc, const hu_payload_telemetry_cfg_t *cfg)
+{
+  if (cfg->mode > HU_TELEMETRY_MODE_ON_DELTA || (cfg->mode == HU_TELEMETRY_MODE_AGGREGATE && cfg->window_ms == 0))
+  {
+    return HU_TELEMETRY_CFG_BAD;
+  }
+
+  // Per-channel state under the old wildcard no longer applies
+  drop(tc->wild, &tc->wild_count, cfg->source_type, cfg->channel);
+  if (cfg->channel == HU_TELEMETRY_ALL_CHANNELS)
+  {
+    drop(tc->streams, &tc->count, cfg->source_type, HU_TELEMETRY_ALL_CHANNELS);
+  }
+
+  hu_telemetry_stream_t *s = find(tc, cfg->source_type, cfg->channel);
+  if (s != NULL)
+  {
+    stream_reset(s, cfg);
+    return HU_TELEMETRY_CFG_APPLIED;
+  }
+  return add(tc, cfg) != NULL ? HU_TELEMETRY_CFG_APPLIED : HU_TELEMETRY_CFG_FULL;
+}
+
+uint16_t hu_telemetry_ctl_period(const hu_telemetry_ctl_t *tc, uint8_t source_type, uint8_t channel,
+                                 uint16_t default_ms)
+{
+  const hu_telemetry_stream_t *wild = NULL;
+  for (uint8_t i = 0; i < tc->count; i++)
+  {
+    const hu_telemetry_stream_t *s = &tc->streams[i];
+    if (s->cfg.source_type != source_type)
+    {
+      continue;
+    }
+    if (s->cfg.channel == channel)
+    {
+      return s->cfg.period_ms;
+    }
+    if (s->cfg.channel == HU_TELEMETRY_ALL_CHANNELS)
+    {
+      wild = s;
+    }
+  }
+  return wild != NULL ? wild->cfg.period_ms : default_ms;
+}
+
+static void window_fill(const hu_telemetry_stream_t *s, hu_payload_data_aggregate_t *agg)
+{
+  agg->source_type = s->cfg.source_type;
+  agg->channel = s->cfg.channel;
+  agg->count = s->count;
+  agg->start_ms = s->start_ms;
+  agg->end_ms = s->end_ms;
+  agg->min_a = s->min_a;
+  agg->max_a = s->max_a;
+  agg->mean_a = (int32_t)(s->sum_a / s->count);
+  agg->last_a = s->last_a;
+  agg->last_b = s->last_b;
+  agg->status = s->status;
+}
+
+static void window_add(hu_telemetry_stream_t *s, uint32_t timestamp_ms, int32_t a, int32_t b, uint8_t status)
+{
+  if (s->count == 0)
+  {
+    s->start_ms = timestamp_ms;
+    s->min_a = a;
+    s->max_a = a;
+    s->sum_a = 0;
+  }
+  s->min_a = a < s->min_a ? a : s->min_a;
+  s->max_a = a > s->max_a ? a : s->max_a;
+  s->sum_a += a;
+  s->count++;
+  s->end_ms = timestamp_ms;
+  s->last_a = a;
+  s->last_b = b;
+  s->status = status;
+}
+
+static hu_telemetry_action_t on_aggregate(hu_telemetry_stream_t *s, uint32_t timestamp_ms, int32_t a, int32_t b,
+                                          uint8_t status, hu_payload_data_aggregate_t *agg)
+{
+  bool close = s->count > 0 && (timestamp_ms - s->start_ms >= s->cfg.window_ms || s->count == UINT16_MAX);
+  if (close)
+  {
+    window_fill(s, agg);
+    s->count = 0;
+  }
+  window_add(s, timestamp_ms, a, b, status);
+  return close ? HU_TELEMETRY_SEND_AGGREGATE : HU_TELEMETRY_DROP;
+}
+
+static hu_telemetry_action_t on_delta(hu_telemetry_stream_t *s, uint32_t timestamp_ms, int32_t a)
+{
+  int64_t diff = (int64_t)a - s->reported_a;
+  bool send = !s->reported || (diff < 0 ? -diff : diff) >= s->cfg.delta_threshold ||
+              (s->cfg.heartbeat_ms != 0 && timestamp_ms - s->reported_ms >= s->cfg.heartbeat_ms);
+  if (!send)
+  {
+    return HU_TELEMETRY_DROP;
+  }
+  s->reported = true;
+  s->reported_a = a;
+  s->reported_ms = timestamp_ms;
+  return HU_TELEMETRY_SEND_RAW;
+}
+
+hu_telemetry_action_t hu_telemetry_ctl_on_sample(hu_telemetry_ctl_t *tc, uint8_t source_type, uint8_t channel,
+                                                 uint32_t timestamp_ms, int32_t a, int32_t b, uint8_t status,
+                                                 hu_payload_data_aggregate_t *agg)
+{
+  hu_telemetry_stream_t *s = find(tc, source_type, channel);
+  if (s == NULL)
+  {
+    hu_telemetry_stream_t *wild = find(tc, source_type, HU_TELEMETRY_ALL_CHANNELS);
+    if (wild == NULL)
+    {
+      return HU_TELEMETRY_SEND_RAW; // Not subscribed: firmware default
+    }
+    s = find_in(tc->wild, tc->wild_count, source_type, channel);
+    if (s == NULL)
+    {
+      const hu_payload_telemetry_cfg_t *w = &wild->cfg;
+      if (w->period_ms == 0 || (w->mode == HU_TELEMETRY_MODE_RAW && w->decimation <= 1))
+      {
+        s = wild; // Stateless: evaluated on the wildcard itself
+      }
+      else if (tc->wild_count < HU_TELEMETRY_WILD_CHANNELS)
+      {
+        s = &tc->wild[tc->wild_count++];
+        stream_reset(s, w);
+        s->cfg.channel = channel;
+      }
+      else
+      {
+        return HU_TELEMETRY_SEND_RAW; // No state left: too much data beats a silent channel
+      }
+    }
+  }
+
+  if (s->cfg.period_ms == 0)
+  {
+    return HU_TELEMETRY_DROP;
+  }
+  switch (s->cfg.mode)
+  {
+  case HU_TELEMETRY_MODE_AGGREGATE:
+    return on_aggregate(s, timestamp_ms, a, b, status, agg);
+  case HU_TELEMETRY_MODE_ON_DELTA:
+    return on_delta(s, timestamp_ms, a);
+  default:
+    if (s->decim_left > 0)
+    {
+      s->decim_left--;
+      return HU_TELEMETRY_DROP;
+    }
+    s->decim_left = s->cfg.decimation > 1 ? (uint8_t)(s->cfg.decimation - 1) : 0;
+    return HU_TELEMETRY_SEND_RAW;
+  }
+}
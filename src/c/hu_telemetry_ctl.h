@@ -0,0 +1,98 @@
+/**
+ * @file hu_telemetry_ctl.h
+ * @brief Node-side telemetry subscriptions (CMD_TELEMETRY_CFG)
+ *
+ * Holds one stream per configured source / channel. Firmware reads each
+ * sensor every hu_telemetry_ctl_period() ms and hands the sample to
+ * hu_telemetry_ctl_on_sample(), which says whether to send it raw, send the
+ * finished window as DATA_AGGREGATE, or drop it. Channels nobody subscribed
+ * to keep the firmware default rate and are sent raw.
+ *
+ * An aggregation window closes on the first sample at or past window_ms from
+ * its start, so it spans whole sampling periods.
+ *
+ * A HU_TELEMETRY_ALL_CHANNELS subscription takes one stream; the channels it
+ * covers keep their decimation / delta / window state in a separate pool, so
+ * they never use up the streams of explicit subscriptions. Plain RAW needs no
+ * per-channel state. Channels beyond the pool are sent raw rather than
+ * silenced.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_TELEMETRY_MAX_STREAMS 8
+#define HU_TELEMETRY_WILD_CHANNELS 16 // Per-channel state under wildcard subscriptions
+
+typedef enum
+{
+  HU_TELEMETRY_DROP = 0,          // Decimated / below delta threshold / window open
+  HU_TELEMETRY_SEND_RAW = 1,      // Report the sample as usual
+  HU_TELEMETRY_SEND_AGGREGATE = 2 // Send *agg as DATA_AGGREGATE
+} hu_telemetry_action_t;
+
+typedef enum
+{
+  HU_TELEMETRY_CFG_APPLIED = 0,
+  HU_TELEMETRY_CFG_BAD = 1, // Unknown mode / zero window: reply HU_ERR_BAD_PAYLOAD
+  HU_TELEMETRY_CFG_FULL = 2 // No free stream: reply HU_ERR_BUSY
+} hu_telemetry_cfg_result_t;
+
+typedef struct
+{
+  hu_payload_telemetry_cfg_t cfg;
+  uint8_t decim_left; // Samples to skip before the next raw report
+
+  // ON_DELTA
+  bool reported;
+  int32_t reported_a;
+  uint32_t reported_ms;
+
+  // AGGREGATE: open window
+  uint16_t count;
+  uint32_t start_ms;
+  int32_t min_a;
+  int32_t max_a;
+  int64_t sum_a;
+  uint32_t end_ms;
+  int32_t last_a;
+  int32_t last_b;
+  uint8_t status;
+} hu_telemetry_stream_t;
+
+typedef struct
+{
+  hu_telemetry_stream_t streams[HU_TELEMETRY_MAX_STREAMS];
+  uint8_t count;
+  hu_telemetry_stream_t wild[HU_TELEMETRY_WILD_CHANNELS]; // Channels under a wildcard stream
+  uint8_t wild_count;
+} hu_telemetry_ctl_t;
+
+void hu_telemetry_ctl_init(hu_telemetry_ctl_t *tc);
+
+// Applies one CMD_TELEMETRY_CFG, restarting that stream's decimation,
+// delta and window state. HU_TELEMETRY_ALL_CHANNELS replaces every stream
+// of the source; channels first seen later follow it.
+hu_telemetry_cfg_result_t hu_telemetry_ctl_apply(hu_telemetry_ctl_t *tc, const hu_payload_telemetry_cfg_t *cfg);
+
+// Sampling period for a channel; default_ms if not subscribed, 0 = off.
+uint16_t hu_telemetry_ctl_period(const hu_telemetry_ctl_t *tc, uint8_t source_type, uint8_t channel,
+                                 uint16_t default_ms);
+
+// One sample (timestamp in network time). agg is filled on SEND_AGGREGATE.
+hu_telemetry_action_t hu_telemetry_ctl_on_sample(hu_telemetry_ctl_t *tc, uint8_t source_type, uint8_t channel,
+                                                 uint32_t timestamp_ms, int32_t a, int32_t b, uint8_t status,
+                                                 hu_payload_data_aggregate_t *agg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file hu_timesync.c
+ * @brief Offset estimation from the four SYS_TIME_SYNC timestamps
+ */
+
+#include "hu_timesync.h"
+
+#include <string.h>
+
+void hu_netclock_init(hu_netclock_t *clk)
+{
+  memset(clk, 0, sizeof(*clk));
+}
+
+void hu_timesync_echo(const hu_payload_time_sync_t *probe, uint32_t rx_ms, uint32_t tx_ms,
+                      hu_payload_time_sync_t *echo)
+{
+  memset(echo, 0, sizeof(*echo));
+  echo->kind = HU_TIME_SYNC_ECHO;
+  echo->t1 = probe->t1;
+  echo->t2 = rx_ms;
+  echo->t3 = tx_ms;
+}
+
+bool hu_netclock_on_follow_up(hu_netclock_t *clk, const hu_payload_time_sync_t *fu, uint32_t local_ms)
+{
+  if (fu->kind != HU_TIME_SYNC_FOLLOW_UP)
+  {
+    return false;
+  }
+  // Differences of same-clock times are wrap-safe in uint32_t
+  int32_t round_trip = (int32_t)(fu->t4 - fu->t1);
+  int32_t turnaround = (int32_t)(fu->t3 - fu->t2);
+  int32_t rtt = round_trip - turnaround;
+  if (round_trip < 0 || turnaround < 0 || rtt < 0 || rtt > HU_TIMESYNC_MAX_RTT_MS)
+  {
+    return false;
+  }
+
+  bool stale = !clk->synced || local_ms - clk->synced_at_ms > HU_TIMESYNC_MAX_AGE_MS;
+  if (!stale && (uint32_t)rtt > clk->rtt_ms + HU_TIMESYNC_RTT_SLACK_MS)
+  {
+    return false;
+  }
+
+  // ((t2 - t1) + (t3 - t4)) / 2, each term a cross-clock difference
+  int64_t sum = (int64_t)(int32_t)(fu->t2 - fu->t1) + (int32_t)(fu->t3 - fu->t4);
+  clk->offset_ms = (int32_t)(sum >= 0 ? (sum + 1) / 2 : (sum - 1) / 2);
+  clk->rtt_ms = (uint32_t)rtt;
+  clk->synced_at_ms = local_ms;
+  clk->synced = true;
+  return true;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file hu_timesync.h
+ * @brief Network time base (SYS_TIME_SYNC) and execute-at-T scheduling
+ *
+ * The coordinator clock is the network time. A node answers each PROBE with
+ * an ECHO and learns its offset from the FOLLOW_UP, which carries all four
+ * timestamps. Path delay through a repeater is symmetric and cancels out.
+ * Samples with a long RTT (queued frame, retransmit) are rejected unless the
+ * current estimate is stale.
+ *
+ * Commands with execute_at_ms (CMD_SET_STATE, CMD_PROFILE_ACTIVATE) and
+ * telemetry timestamps use network time.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_TIMESYNC_MAX_RTT_MS 20    // Samples above this are never used
+#define HU_TIMESYNC_RTT_SLACK_MS 2   // Accept if RTT <= best RTT + slack
+#define HU_TIMESYNC_MAX_AGE_MS 30000 // Older estimate: accept any valid sample
+
+typedef struct
+{
+  bool synced;
+  int32_t offset_ms;     // local - network
+  uint32_t rtt_ms;       // Of the sample in use
+  uint32_t synced_at_ms; // Local time of that sample
+} hu_netclock_t;
+
+void hu_netclock_init(hu_netclock_t *clk);
+
+// Node: answer to a PROBE. rx_ms / tx_ms are local times of reception and
+// of sending the reply.
+void hu_timesync_echo(const hu_payload_time_sync_t *probe, uint32_t rx_ms, uint32_t tx_ms,
+                      hu_payload_time_sync_t *echo);
+
+// Node: returns true if the FOLLOW_UP sample was taken.
+bool hu_netclock_on_follow_up(hu_netclock_t *clk, const hu_payload_time_sync_t *fu, uint32_t local_ms);
+
+static inline uint32_t hu_netclock_now(const hu_netclock_t *clk, uint32_t local_ms)
+{
+  return local_ms - (uint32_t)clk->offset_ms;
+}
+
+static inline uint32_t hu_netclock_to_local(const hu_netclock_t *clk, uint32_t net_ms)
+{
+  return net_ms + (uint32_t)clk->offset_ms;
+}
+
+// True once execute_at_ms (network time, 0 = immediately) has been reached.
+// Wrap-safe for deadlines up to 2^31 ms ahead.
+static inline bool hu_netclock_due(const hu_netclock_t *clk, uint32_t local_ms, uint32_t execute_at_ms)
+{
+  return execute_at_ms == 0 || (int32_t)(hu_netclock_now(clk, local_ms) - execute_at_ms) >= 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,218 @@
+/**
+ * @file hu_tunnel.c
+ * @brief COBS link packets with CRC and multi-frame records
+ */
+
+#include "hu_tunnel.h"
+#include "hu_crc.h"
+
+#include <string.h>
+
+#define MIN_PACKET (sizeof(hu_tunnel_header_t) + HU_FRAME_CRC_SIZE)
+
+size_t hu_cobs_encode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+  size_t out = 1;
+  size_t code_pos = 0;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++)
+  {
+    if (src[i] == 0)
+    {
+      dst[code_pos] = code;
+      code_pos = out++;
+      code = 1;
+      continue;
+    }
+    dst[out++] = src[i];
+    if (++code == 0xFF)
+    {
+      dst[code_pos] = code;
+      code_pos = out++;
+      code = 1;
+    }
+  }
+  dst[code_pos] = code;
+  return out;
+}
+
+size_t hu_cobs_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap)
+{
+  // Output never overtakes input, so src == dst is safe
+  size_t in = 0;
+  size_t out = 0;
+  while (in < len)
+  {
+    uint8_t code = src[in++];
+    if (code == 0 || in + code - 1 > len || out + code - 1 > cap)
+    {
+      return 0;
+    }
+    for (uint8_t i = 1; i < code; i++)
+    {
+      dst[out++] = src[in++];
+    }
+    if (code != 0xFF && in < len)
+    {
+      if (out >= cap)
+      {
+        return 0;
+      }
+      dst[out++] = 0;
+    }
+  }
+  return out;
+}
+
+// --- Sender ---
+
+static void tx_start(hu_tunnel_tx_t *t)
+{
+  hu_tunnel_header_t head = {HU_TUNNEL_KIND_MESH, t->seq, 0};
+  memcpy(t->raw, &head, sizeof(head));
+  t->len = sizeof(head);
+}
+
+void hu_tunnel_tx_init(hu_tunnel_tx_t *t)
+{
+  memset(t, 0, sizeof(*t));
+  tx_start(t);
+}
+
+bool hu_tunnel_tx_add(hu_tunnel_tx_t *t, const uint8_t *frame, uint8_t len, int8_t rssi_dbm, uint32_t rx_us)
+{
+  hu_tunnel_header_t *head = (hu_tunnel_header_t *)(void *)t->raw;
+  size_t need = sizeof(hu_tunnel_record_t) + len;
+  if (head->count == UINT8_MAX || t->len + need + HU_FRAME_CRC_SIZE > HU_TUNNEL_MAX_RAW)
+  {
+    return false;
+  }
+  hu_tunnel_record_t rec = {len, rssi_dbm, rx_us};
+  memcpy(t->raw + t->len, &rec, sizeof(rec));
+  memcpy(t->raw + t->len + sizeof(rec), frame, len);
+  t->len = (uint16_t)(t->len + need);
+  head->count++;
+  return true;
+}
+
+size_t hu_tunnel_tx_finish(hu_tunnel_tx_t *t, uint8_t *out)
+{
+  if (hu_tunnel_tx_empty(t))
+  {
+    return 0;
+  }
+  uint16_t crc = hu_crc16(0, t->raw, t->len);
+  t->raw[t->len] = (uint8_t)crc;
+  t->raw[t->len + 1] = (uint8_t)(crc >> 8);
+
+  size_t n = hu_cobs_encode(t->raw, (size_t)t->len + HU_FRAME_CRC_SIZE, out);
+  out[n++] = HU_TUNNEL_DELIMITER;
+
+  t->seq++;
+  tx_start(t);
+  return n;
+}
+
+// --- Receiver ---
+
+void hu_tunnel_rx_init(hu_tunnel_rx_t *r, hu_tunnel_frame_fn on_frame, void *ctx)
+{
+  memset(r, 0, sizeof(*r));
+  r->on_frame = on_frame;
+  r->ctx = ctx;
+}
+
+// Checks the record layout of a decoded packet before anything is delivered
+static bool records_valid(const uint8_t *p, size_t len, uint8_t count)
+{
+  size_t pos = sizeof(hu_tunnel_header_t);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (pos + sizeof(hu_tunnel_record_t) > len)
+    {
+      return false;
+    }
+    pos += sizeof(hu_tunnel_record_t) + p[pos];
+  }
+  return pos == len;
+}
+
+static void rx_packet(hu_tunnel_rx_t *r)
+{
+  size_t n = hu_cobs_decode(r->buf, r->len, r->buf, sizeof(r->buf));
+  if (n == 0)
+  {
+    return; // Empty packet (idle delimiter) or garbage before the first one
+  }
+  if (n < MIN_PACKET)
+  {
+    r->bad_packets++;
+    return;
+  }
+  size_t body = n - HU_FRAME_CRC_SIZE;
+  uint16_t crc = hu_crc16(0, r->buf, body);
+  hu_tunnel_header_t head;
+  memcpy(&head, r->buf, sizeof(head));
+  if (r->buf[body] != (uint8_t)crc || r->buf[body + 1] != (uint8_t)(crc >> 8) || head.kind != HU_TUNNEL_KIND_MESH ||
+      !records_valid(r->buf, body, head.count))
+  {
+    r->bad_packets++;
+    return;
+  }
+
+  if (r->synced)
+  {
+    r->lost_packets += (uint8_t)(head.seq - r->next_seq);
+  }
+  r->next_seq = (uint8_t)(head.seq + 1);
+  r->synced = true;
+  r->packets++;
+
+  size_t pos = sizeof(head);
+  for (uint8_t i = 0; i < head.count; i++)
+  {
+    hu_tunnel_record_t rec;
+    memcpy(&rec, r->buf + pos, sizeof(rec));
+    r->on_frame(r->buf + pos + sizeof(rec), rec.len, &rec, r->ctx);
+    pos += sizeof(rec) + rec.len;
+  }
+}
+
+void hu_tunnel_rx_feed(hu_tunnel_rx_t *r, const uint8_t *data, size_t len)
+{
+  while (len > 0)
+  {
+    const uint8_t *delim = (const uint8_t *)memchr(data, HU_TUNNEL_DELIMITER, len);
+    size_t chunk = delim != NULL ? (size_t)(delim - data) : len;
+
+    if (!r->overflow)
+    {
+      if (r->len + chunk > sizeof(r->buf))
+      {
+        r->overflow = true;
+      }
+      else
+      {
+        memcpy(r->buf + r->len, data, chunk);
+        r->len = (uint16_t)(r->len + chunk);
+      }
+    }
+    if (delim == NULL)
+    {
+      return;
+    }
+
+    if (r->overflow)
+    {
+      r->bad_packets++;
+    }
+    else
+    {
+      rx_packet(r);
+    }
+    r->len = 0;
+    r->overflow = false;
+    data += chunk + 1;
+    len -= chunk + 1;
+  }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file hu_tunnel.h
+ * @brief Serial tunnel framing between the coordinator dongle and the RPi
+ *
+ * Link packets are COBS-encoded and terminated by 0x00. The delimiter never
+ * occurs inside a packet, so a receiver resyncs at the next 0x00 after any
+ * error instead of hunting for HU_PROTOCOL_MAGIC inside payload bytes.
+ *
+ * Raw packet (before COBS):
+ *   hu_tunnel_header_t | { hu_tunnel_record_t, frame[len] } * count | crc16
+ *
+ * One packet carries as many mesh frames as fit HU_TUNNEL_MAX_RAW, so the
+ * dongle writes one USB transfer per packet and the gateway reads in bulk.
+ * Each record carries dongle-side metadata (RSSI, receive time) out of band,
+ * i.e. without touching the mesh frame bytes.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_TUNNEL_DELIMITER 0x00
+#define HU_TUNNEL_MAX_RAW 1024 // Raw packet incl. header and CRC
+// Worst-case COBS output for n input bytes, plus the delimiter
+#define HU_TUNNEL_ENCODED_MAX(n) ((n) + (n) / 254 + 2)
+
+#define HU_TUNNEL_KIND_MESH 0x01 // Records are mesh frames (both directions)
+
+#pragma pack(push, 1)
+
+typedef struct
+{
+  uint8_t kind;  // HU_TUNNEL_KIND_*
+  uint8_t seq;   // Per-direction packet counter: gaps = lost packets
+  uint8_t count; // Records in this packet
+} hu_tunnel_header_t;
+
+typedef struct
+{
+  uint8_t len;     // Mesh frame bytes that follow
+  int8_t rssi_dbm; // Dongle -> RPi: rx_ctrl->rssi. RPi -> dongle: 0
+  uint32_t rx_us;  // Dongle -> RPi: dongle receive time. RPi -> dongle: 0
+} hu_tunnel_record_t;
+
+#pragma pack(pop)
+
+HU_STATIC_ASSERT(sizeof(hu_tunnel_header_t) == 3, "hu_tunnel_header_t must be 3 bytes");
+HU_STATIC_ASSERT(sizeof(hu_tunnel_record_t) == 6, "hu_tunnel_record_t must be 6 bytes");
+HU_STATIC_ASSERT(HU_MAX_FRAME_SIZE <= UINT8_MAX, "record len is a uint8_t");
+
+// --- COBS ---
+
+// dst needs HU_TUNNEL_ENCODED_MAX(len) - 1 bytes. Returns bytes written
+// (no delimiter).
+size_t hu_cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+
+// Decodes one packet without its delimiter. Returns decoded length, 0 on a
+// malformed packet or if it exceeds cap. dst may equal src (in place).
+size_t hu_cobs_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+// --- Sender ---
+
+typedef struct
+{
+  uint8_t raw[HU_TUNNEL_MAX_RAW];
+  uint16_t len;
+  uint8_t seq;
+} hu_tunnel_tx_t;
+
+void hu_tunnel_tx_init(hu_tunnel_tx_t *t);
+
+// Appends a mesh frame. Returns false if it does not fit: send the packet
+// (hu_tunnel_tx_finish) and add it again.
+bool hu_tunnel_tx_add(hu_tunnel_tx_t *t, const uint8_t *frame, uint8_t len, int8_t rssi_dbm, uint32_t rx_us);
+
+static inline bool hu_tunnel_tx_empty(const hu_tunnel_tx_t *t)
+{
+  return ((const hu_tunnel_header_t *)(const void *)t->raw)->count == 0;
+}
+
+// Appends the CRC, COBS-encodes into out (at least
+// HU_TUNNEL_ENCODED_MAX(HU_TUNNEL_MAX_RAW) bytes) incl. delimiter and starts
+// the next packet. Returns bytes to write, 0 if there was nothing to send.
+size_t hu_tunnel_tx_finish(hu_tunnel_tx_t *t, uint8_t *out);
+
+// --- Receiver ---
+
+// Called for every mesh frame of a valid packet
+typedef void (*hu_tunnel_frame_fn)(const uint8_t *frame, uint8_t len, const hu_tunnel_record_t *meta, void *ctx);
+
+typedef struct
+{
+  uint8_t buf[HU_TUNNEL_ENCODED_MAX(HU_TUNNEL_MAX_RAW)];
+  uint16_t len;
+  bool overflow;    // Current packet too long: skip to the next delimiter
+  uint8_t next_seq; // Expected packet seq
+  bool synced;      // next_seq is meaningful
+  hu_tunnel_frame_fn on_frame;
+  void *ctx;
+
+  uint32_t packets;
+  uint32_t bad_packets;  // COBS / CRC / layout errors
+  uint32_t lost_packets; // From seq gaps
+} hu_tunnel_rx_t;
+
+void hu_tunnel_rx_init(hu_tunnel_rx_t *r, hu_tunnel_frame_fn on_frame, void *ctx);
+
+// Feeds received serial bytes (any chunking).
+void hu_tunnel_rx_feed(hu_tunnel_rx_t *r, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file hu_tx_sched.c
+ * @brief Priority lanes and telemetry supersede / expiry
+ */
+
+#include "hu_tx_sched.h"
+
+#include <string.h>
+
+HU_STATIC_ASSERT(HU_TX_LANE_CAPACITY >= 1 && HU_TX_LANE_CAPACITY <= 8, "used_mask is a uint8_t");
+
+void hu_tx_sched_init(hu_tx_sched_t *s, uint16_t telemetry_max_age_ms)
+{
+  memset(s, 0, sizeof(*s));
+  for (int i = 0; i < HU_TX_LANE_COUNT; i++)
+  {
+    s->lanes[i].depth = HU_TX_LANE_CAPACITY;
+  }
+  s->telemetry_max_age_ms = telemetry_max_age_ms;
+}
+
+bool hu_tx_sched_set_depth(hu_tx_sched_t *s, hu_tx_lane_id_t lane, uint8_t depth)
+{
+  if (lane >= HU_TX_LANE_COUNT || depth == 0 || depth > HU_TX_LANE_CAPACITY || s->lanes[lane].count != 0)
+  {
+    return false;
+  }
+  s->lanes[lane].depth = depth;
+  return true;
+}
+
+hu_tx_lane_id_t hu_tx_lane_of(uint8_t msg_type)
+{
+  if (msg_type == HU_MSG_EVENT_CRITICAL)
+  {
+    return HU_TX_LANE_SAFETY;
+  }
+  // Display refresh yields to control traffic and ages out like telemetry
+  if (msg_type >= HU_MSG_DATA_SENSOR || msg_type == HU_MSG_CMD_UI_UPDATE)
+  {
+    return HU_TX_LANE_TELEMETRY;
+  }
+  if (msg_type >= HU_MSG_EVENT_UI_INPUT || msg_type == HU_MSG_BATCH)
+  {
+    return HU_TX_LANE_EVENT;
+  }
+  return HU_TX_LANE_CONTROL;
+}
+
+static void count_drop(hu_tx_sched_t *s)
+{
+  s->dropped++;
+  if (s->stats != NULL)
+  {
+    s->stats->tx_dropped++;
+  }
+}
+
+// Removes order[pos], freeing its slot
+static void lane_remove(hu_tx_lane_t *l, uint8_t pos)
+{
+  l->used_mask &= (uint8_t)~(1u << l->order[pos]);
+  memmove(&l->order[pos], &l->order[pos + 1], (size_t)(l->count - pos - 1));
+  l->count--;
+}
+
+hu_tx_push_result_t hu_tx_push(hu_tx_sched_t *s, hu_tx_lane_id_t lane, const uint8_t *frame, uint16_t len,
+                               uint16_t key, uint32_t now_ms)
+{
+  if (len > HU_MAX_FRAME_SIZE || lane >= HU_TX_LANE_COUNT)
+  {
+    return HU_TX_TOO_LONG;
+  }
+  hu_tx_lane_t *l = &s->lanes[lane];
+
+  if (key != HU_TX_KEY_NONE)
+  {
+    for (uint8_t pos = l->head_in_flight ? 1 : 0; pos < l->count; pos++)
+    {
+      hu_tx_slot_t *slot = &l->slots[l->order[pos]];
+      if (slot->key == key)
+      {
+        memcpy(slot->frame, frame, len);
+        slot->len = len;
+        slot->queued_ms = now_ms;
+        s->superseded++;
+        return HU_TX_SUPERSEDED;
+      }
+    }
+  }
+
+  hu_tx_push_result_t result = HU_TX_QUEUED;
+  if (l->count >= l->depth)
+  {
+    uint8_t oldest = l->head_in_flight ? 1 : 0;
+    if (lane != HU_TX_LANE_TELEMETRY || oldest >= l->count)
+    {
+      count_drop(s);
+      return HU_TX_FULL;
+    }
+    lane_remove(l, oldest);
+    count_drop(s);
+    result = HU_TX_DROPPED_OLDEST;
+  }
+
+  uint8_t idx = 0;
+  while (l->used_mask & (1u << idx))
+  {
+    idx++;
+  }
+  hu_tx_slot_t *slot = &l->slots[idx];
+  memcpy(slot->frame, frame, len);
+  slot->len = len;
+  slot->key = key;
+  slot->queued_ms = now_ms;
+  l->used_mask |= (uint8_t)(1u << idx);
+  l->order[l->count++] = idx;
+  return result;
+}
+
+const hu_tx_slot_t *hu_tx_next(hu_tx_sched_t *s, uint32_t now_ms, hu_tx_lane_id_t *lane)
+{
+  for (int i = 0; i < HU_TX_LANE_COUNT; i++)
+  {
+    hu_tx_lane_t *l = &s->lanes[i];
+    if (l->head_in_flight)
+    {
+      return NULL; // Strict priority: lower lanes wait for this one too
+    }
+    if (l->count == 0)
+    {
+      continue;
+    }
+    // Safety preempts: it may join a frame already in flight
+    if (s->in_flight != 0 && i != HU_TX_LANE_SAFETY)
+    {
+      return NULL;
+    }
+    if (i == HU_TX_LANE_TELEMETRY && s->telemetry_max_age_ms != 0)
+    {
+      while (l->count != 0 && now_ms - l->slots[l->order[0]].queued_ms > s->telemetry_max_age_ms)
+      {
+        lane_remove(l, 0);
+        count_drop(s);
+      }
+      if (l->count == 0)
+      {
+        return NULL;
+      }
+    }
+    const hu_tx_slot_t *slot = &l->slots[l->order[0]];
+    l->head_in_flight = true;
+    s->in_flight++;
+    if (s->stats != NULL)
+    {
+      s->stats->tx_frames++;
+      hu_stats_latency(s->stats, HU_STATS_HIST_TX_QUEUE, now_ms - slot->queued_ms);
+    }
+    *lane = (hu_tx_lane_id_t)i;
+    return slot;
+  }
+  return NULL;
+}
+
+void hu_tx_done(hu_tx_sched_t *s, hu_tx_lane_id_t lane)
+{
+  if (lane >= HU_TX_LANE_COUNT)
+  {
+    return;
+  }
+  hu_tx_lane_t *l = &s->lanes[lane];
+  if (!l->head_in_flight)
+  {
+    return;
+  }
+  l->head_in_flight = false;
+  lane_remove(l, 0);
+  s->in_flight--;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file hu_tx_sched.h
+ * @brief Strict-priority TX scheduler: safety, control, events, telemetry
+ *
+ * Frames wait in one of four bounded lanes and the highest non-empty lane
+ * always goes first, so EVENT_CRITICAL never queues behind telemetry.
+ * One frame is in flight at a time (ESP-NOW send callback -> hu_tx_done());
+ * a SAFETY frame may be issued while another frame is still in flight.
+ *
+ * Telemetry never blocks the sender: a full lane drops its oldest frame,
+ * a frame with the same supersede key replaces the queued older sample in
+ * place, and samples older than the configured age are discarded.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+#include "hu_stats.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef HU_TX_LANE_CAPACITY
+#define HU_TX_LANE_CAPACITY 4 // Slots per lane (max 8)
+#endif
+
+#define HU_TX_KEY_NONE 0 // Never superseded
+// Supersede key for one telemetry stream (e.g. DATA_MULTI channel)
+#define HU_TX_KEY(msg_type, channel) ((uint16_t)(((uint16_t)(msg_type) << 8) | (uint8_t)(channel)))
+
+typedef enum
+{
+  HU_TX_LANE_SAFETY = 0,    // EVENT_CRITICAL
+  HU_TX_LANE_CONTROL = 1,   // ACK / ERROR / SYS_* / CMD_*
+  HU_TX_LANE_EVENT = 2,     // EVENT_* / BATCH
+  HU_TX_LANE_TELEMETRY = 3, // DATA_* / CMD_UI_UPDATE
+  HU_TX_LANE_COUNT = 4
+} hu_tx_lane_id_t;
+
+typedef enum
+{
+  HU_TX_QUEUED = 0,
+  HU_TX_SUPERSEDED = 1,     // Replaced a queued frame with the same key
+  HU_TX_DROPPED_OLDEST = 2, // Telemetry lane full: oldest waiting frame dropped
+  HU_TX_FULL = 3,           // Lane full, frame not queued
+  HU_TX_TOO_LONG = 4
+} hu_tx_push_result_t;
+
+typedef struct
+{
+  uint16_t len;
+  uint16_t key;
+  uint32_t queued_ms;
+  uint8_t frame[HU_MAX_FRAME_SIZE];
+} hu_tx_slot_t;
+
+typedef struct
+{
+  uint8_t order[HU_TX_LANE_CAPACITY]; // Slot indexes, order[0] = oldest
+  uint8_t count;
+  uint8_t depth;     // Bound, <= HU_TX_LANE_CAPACITY
+  uint8_t used_mask; // Bit per slot
+  bool head_in_flight;
+  hu_tx_slot_t slots[HU_TX_LANE_CAPACITY];
+} hu_tx_lane_t;
+
+typedef struct
+{
+  hu_tx_lane_t lanes[HU_TX_LANE_COUNT];
+  uint8_t in_flight;
+  uint16_t telemetry_max_age_ms; // 0 = no age limit
+  uint32_t dropped;              // Full lanes, oldest drops, expired telemetry
+  uint32_t superseded;
+  hu_stats_t *stats; // Optional: set after hu_tx_sched_init()
+} hu_tx_sched_t;
+
+// Every lane at HU_TX_LANE_CAPACITY.
+void hu_tx_sched_init(hu_tx_sched_t *s, uint16_t telemetry_max_age_ms);
+
+// Bounds one lane (1 .. HU_TX_LANE_CAPACITY). Call while the lane is empty.
+bool hu_tx_sched_set_depth(hu_tx_sched_t *s, hu_tx_lane_id_t lane, uint8_t depth);
+
+// Default lane for a message type
+hu_tx_lane_id_t hu_tx_lane_of(uint8_t msg_type);
+
+// Copies an encoded frame into the lane. key != HU_TX_KEY_NONE replaces a
+// waiting frame with the same key (newer sample, same queue position).
+hu_tx_push_result_t hu_tx_push(hu_tx_sched_t *s, hu_tx_lane_id_t lane, const uint8_t *frame, uint16_t len,
+                               uint16_t key, uint32_t now_ms);
+
+// Next frame to hand to the radio, NULL if nothing may be sent now. The
+// slot stays valid (and is not superseded) until hu_tx_done(lane).
+const hu_tx_slot_t *hu_tx_next(hu_tx_sched_t *s, uint32_t now_ms, hu_tx_lane_id_t *lane);
+
+// Transmission of the in-flight frame of `lane` finished (either outcome).
+void hu_tx_done(hu_tx_sched_t *s, hu_tx_lane_id_t lane);
+
+static inline bool hu_tx_idle(const hu_tx_sched_t *s)
+{
+  for (int i = 0; i < HU_TX_LANE_COUNT; i++)
+  {
+    if (s->lanes[i].count != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file hu_widget.c
+ * @brief Widget cache: definitions, dirty-field updates, redraw queue
+ */
+
+#include "hu_widget.h"
+
+#include <string.h>
+
+#define DIRTY_KNOWN 0x7F // Every HU_UI_DIRTY_* bit
+
+HU_STATIC_ASSERT(HU_WIDGET_MAX <= 32, "dirty_mask is a uint32_t");
+
+static void mark(hu_widget_cache_t *c, uint8_t id, uint8_t fields)
+{
+  c->widgets[id].dirty |= fields;
+  c->dirty_mask |= (uint32_t)1 << id;
+}
+
+// Length of the record at p (header included), 0 if malformed
+static uint8_t record_len(const uint8_t *p, uint8_t avail)
+{
+  if (avail < sizeof(hu_ui_update_record_t))
+  {
+    return 0;
+  }
+  hu_ui_update_record_t r;
+  memcpy(&r, p, sizeof(r));
+  if (r.widget_id >= HU_WIDGET_MAX || (r.dirty & ~DIRTY_KNOWN) != 0 ||
+      (r.dirty & (HU_UI_DIRTY_VALUE | HU_UI_DIRTY_VALUE16)) == (HU_UI_DIRTY_VALUE | HU_UI_DIRTY_VALUE16))
+  {
+    return 0;
+  }
+  uint16_t n = sizeof(r);
+  n += (r.dirty & HU_UI_DIRTY_VALUE) ? 4 : 0;
+  n += (r.dirty & HU_UI_DIRTY_VALUE16) ? 2 : 0;
+  n += (r.dirty & HU_UI_DIRTY_FLAGS) ? 1 : 0;
+  n += (r.dirty & HU_UI_DIRTY_COLOR) ? 1 : 0;
+  n += (r.dirty & HU_UI_DIRTY_RANGE) ? 8 : 0;
+  n += (r.dirty & HU_UI_DIRTY_RECT) ? 4 : 0;
+  if (r.dirty & HU_UI_DIRTY_LABEL)
+  {
+    if (n >= avail || p[n] > HU_WIDGET_LABEL_MAX)
+    {
+      return 0;
+    }
+    n += 1 + p[n];
+  }
+  return n <= avail ? (uint8_t)n : 0;
+}
+
+static void apply_record(hu_widget_t *w, const uint8_t *p)
+{
+  hu_ui_update_record_t r;
+  memcpy(&r, p, sizeof(r));
+  p += sizeof(r);
+  if (r.dirty & HU_UI_DIRTY_VALUE)
+  {
+    memcpy(&w->def.value, p, 4);
+    p += 4;
+  }
+  if (r.dirty & HU_UI_DIRTY_VALUE16)
+  {
+    int16_t v;
+    memcpy(&v, p, 2);
+    w->def.value = v;
+    p += 2;
+  }
+  if (r.dirty & HU_UI_DIRTY_FLAGS)
+  {
+    w->def.flags = *p++;
+  }
+  if (r.dirty & HU_UI_DIRTY_COLOR)
+  {
+    w->def.color = *p++;
+  }
+  if (r.dirty & HU_UI_DIRTY_RANGE)
+  {
+    memcpy(&w->def.min, p, 4);
+    memcpy(&w->def.max, p + 4, 4);
+    p += 8;
+  }
+  if (r.dirty & HU_UI_DIRTY_RECT)
+  {
+    w->def.x = p[0];
+    w->def.y = p[1];
+    w->def.w = p[2];
+    w->def.h = p[3];
+    p += 4;
+  }
+  if (r.dirty & HU_UI_DIRTY_LABEL)
+  {
+    w->label_len = p[0];
+    memcpy(w->label, p + 1, w->label_len);
+  }
+}
+
+void hu_widget_cache_init(hu_widget_cache_t *c)
+{
+  memset(c, 0, sizeof(*c));
+}
+
+hu_widget_result_t hu_widget_define(hu_widget_cache_t *c, const uint8_t *payload, uint8_t len)
+{
+  if (len < sizeof(hu_payload_ui_widget_t) || len - sizeof(hu_payload_ui_widget_t) > HU_WIDGET_LABEL_MAX)
+  {
+    return HU_WIDGET_ERR_SIZE;
+  }
+  hu_payload_ui_widget_t def;
+  memcpy(&def, payload, sizeof(def));
+  if (def.widget_id >= HU_WIDGET_MAX || def.kind > HU_WIDGET_ICON)
+  {
+    return HU_WIDGET_ERR_SIZE;
+  }
+
+  hu_widget_t *w = &c->widgets[def.widget_id];
+  if (def.kind == HU_WIDGET_NONE)
+  {
+    if (w->def.kind != HU_WIDGET_NONE)
+    {
+      w->def.kind = HU_WIDGET_NONE; // Keeps the rect for the erase
+      mark(c, def.widget_id, HU_UI_DIRTY_ALL);
+    }
+    return HU_WIDGET_OK;
+  }
+  w->def = def;
+  w->label_len = (uint8_t)(len - sizeof(def));
+  memcpy(w->label, payload + sizeof(def), w->label_len);
+  mark(c, def.widget_id, HU_UI_DIRTY_ALL);
+  return HU_WIDGET_OK;
+}
+
+hu_widget_result_t hu_widget_update(hu_widget_cache_t *c, const uint8_t *payload, uint8_t len, uint8_t *missing_id)
+{
+  if (len < sizeof(hu_payload_ui_update_t))
+  {
+    return HU_WIDGET_ERR_SIZE;
+  }
+  hu_payload_ui_update_t head;
+  memcpy(&head, payload, sizeof(head));
+
+  const uint8_t *p = payload + sizeof(head);
+  uint8_t avail = (uint8_t)(len - sizeof(head));
+  for (uint8_t i = 0; i < head.count; i++)
+  {
+    uint8_t n = record_len(p, avail);
+    if (n == 0)
+    {
+      return HU_WIDGET_ERR_SIZE;
+    }
+    p += n;
+    avail = (uint8_t)(avail - n);
+  }
+  if (avail != 0)
+  {
+    return HU_WIDGET_ERR_SIZE;
+  }
+
+  hu_widget_result_t res = HU_WIDGET_OK;
+  p = payload + sizeof(head);
+  for (uint8_t i = 0; i < head.count; i++)
+  {
+    uint8_t n = record_len(p, (uint8_t)(payload + len - p));
+    hu_ui_update_record_t r;
+    memcpy(&r, p, sizeof(r));
+    hu_widget_t *w = &c->widgets[r.widget_id];
+    if (w->def.kind == HU_WIDGET_NONE)
+    {
+      if (res == HU_WIDGET_OK)
+      {
+        *missing_id = r.widget_id;
+        res = HU_WIDGET_ERR_NOT_CACHED;
+      }
+    }
+    else
+    {
+      apply_record(w, p);
+      uint8_t fields = r.dirty;
+      if (fields & HU_UI_DIRTY_VALUE16)
+      {
+        fields = (uint8_t)((fields & ~HU_UI_DIRTY_VALUE16) | HU_UI_DIRTY_VALUE); // Renderer sees one value bit
+      }
+      mark(c, r.widget_id, fields);
+    }
+    p += n;
+  }
+  return res;
+}
+
+const hu_widget_t *hu_widget_next_dirty(hu_widget_cache_t *c, uint8_t *fields)
+{
+  if (c->dirty_mask == 0)
+  {
+    return NULL;
+  }
+  for (uint8_t k = 0; k < HU_WIDGET_MAX; k++)
+  {
+    uint8_t id = (uint8_t)((c->next_scan + k) % HU_WIDGET_MAX);
+    if (c->dirty_mask & ((uint32_t)1 << id))
+    {
+      hu_widget_t *w = &c->widgets[id];
+      *fields = w->dirty;
+      w->dirty = 0;
+      c->dirty_mask &= ~((uint32_t)1 << id);
+      c->next_scan = (uint8_t)(id + 1);
+      return w;
+    }
+  }
+  return NULL;
+}
+
+const hu_widget_t *hu_widget_get(const hu_widget_cache_t *c, uint8_t widget_id)
+{
+  if (widget_id >= HU_WIDGET_MAX || c->widgets[widget_id].def.kind == HU_WIDGET_NONE)
+  {
+    return NULL;
+  }
+  return &c->widgets[widget_id];
+}
@@ -0,0 +1,71 @@
+/**
+ * @file hu_widget.h
+ * @brief Node-side widget cache: CMD_UI_WIDGET definitions, CMD_UI_UPDATE deltas
+ *
+ * The RPi defines each widget once (CMD_UI_WIDGET, with ACK) and from then
+ * on sends only the fields that changed, for several widgets per frame
+ * (CMD_UI_UPDATE, no ACK). The cache marks what changed; the renderer pulls
+ * dirty widgets at its own frame rate with hu_widget_next_dirty(), so
+ * updates arriving faster than the display refresh merge into one redraw.
+ *
+ * The cache does not survive a reboot: an update for an undefined widget
+ * answers ERROR HU_ERR_WIDGET_NOT_CACHED and the RPi re-sends the definitions.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "headunit_protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define HU_UI_DIRTY_ALL 0xFF // Redraw everything (new definition / removal)
+
+typedef enum
+{
+  HU_WIDGET_OK = 0,
+  HU_WIDGET_ERR_SIZE = 1,      // Malformed payload, nothing applied: HU_ERR_BAD_PAYLOAD
+  HU_WIDGET_ERR_NOT_CACHED = 2 // Some records name undefined widgets, the rest applied
+} hu_widget_result_t;
+
+typedef struct
+{
+  hu_payload_ui_widget_t def; // kind HU_WIDGET_NONE = empty slot
+  uint8_t label_len;
+  uint8_t label[HU_WIDGET_LABEL_MAX];
+  uint8_t dirty; // HU_UI_DIRTY_* changed since the last redraw
+} hu_widget_t;
+
+typedef struct
+{
+  hu_widget_t widgets[HU_WIDGET_MAX];
+  uint32_t dirty_mask; // Bit per widget waiting for a redraw
+  uint8_t next_scan;   // Round-robin start of hu_widget_next_dirty()
+} hu_widget_cache_t;
+
+void hu_widget_cache_init(hu_widget_cache_t *c);
+
+// CMD_UI_WIDGET: replaces the widget, kind NONE removes it.
+hu_widget_result_t hu_widget_define(hu_widget_cache_t *c, const uint8_t *payload, uint8_t len);
+
+// CMD_UI_UPDATE: the whole payload is checked before any record is applied.
+// On HU_WIDGET_ERR_NOT_CACHED, *missing_id is the first undefined widget.
+hu_widget_result_t hu_widget_update(hu_widget_cache_t *c, const uint8_t *payload, uint8_t len, uint8_t *missing_id);
+
+// Next widget to redraw, NULL if none. *fields gets its dirty bits, which
+// are cleared (VALUE16 is reported as VALUE). A removed widget (kind NONE)
+// comes once so its area is erased; on RECT the renderer erases the rect it
+// drew last.
+const hu_widget_t *hu_widget_next_dirty(hu_widget_cache_t *c, uint8_t *fields);
+
+// Cached widget, NULL if undefined
+const hu_widget_t *hu_widget_get(const hu_widget_cache_t *c, uint8_t widget_id);
+
+#ifdef __cplusplus
+}
+#endif
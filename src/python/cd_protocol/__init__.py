@@ -1,7 +1,12 @@
 import struct
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from enum import IntEnum
-from typing import Optional, List, Tuple
+from typing import Dict, Optional, List, Tuple
+
+try:
+    import numpy as np
+except ImportError:  # pragma: no cover - optional dependency
+    np = None
 
 # === 1. CONSTANTS ===
 HU_PROTOCOL_MAGIC = 0xA5
@@ -9,12 +14,23 @@ HU_PROTOCOL_VERSION = 0x02
 HU_MAX_PAYLOAD_SIZE = 230
 HEADER_SIZE = 9  # struct.calcsize("<BBBBBBHB")
 
+# Header flags
+FLAG_NEED_ACK = 0x01
+FLAG_WINDOWED = 0x02  # seq_num is a per-link reliable stream
+FLAG_SYN = 0x04  # First window of a reliable stream
+FLAG_CRC = 0x08  # CRC-16/X-25 trailer after the payload
+FLAG_EPOCH_MASK = 0x30  # WINDOWED: stream epoch, changes on every restart
+FLAG_EPOCH_SHIFT = 4
+CRC_SIZE = 2
+
 
 # === 2. ADDRESSING & TYPES ===
 class DeviceAddress(IntEnum):
     COORDINATOR = 0x01
     BROADCAST = 0xFF
     UNASSIGNED = 0xFE
+    MIN_GROUP = 0xF1
+    MAX_GROUP = 0xFD
 
 
 class DeviceType(IntEnum):
@@ -36,29 +52,49 @@ class MsgType(IntEnum):
     PING = 0x01
     ACK = 0x02
     ERROR = 0x03
+    BATCH = 0x04  # Container of sub-messages
 
     # Provisioning
     SYS_DISCOVERY_REQ = 0x05
     SYS_DISCOVERY_RES = 0x06
     SYS_ASSIGN_ID = 0x07
     SYS_REBOOT = 0x08
+    SYS_ROUTE_UPDATE = 0x09
+    SYS_RSSI_SURVEY = 0x0A
+    SYS_RSSI_REPORT = 0x0B
+    SYS_TIME_SYNC = 0x0C
+    SYS_GROUP_SET = 0x0D
+    SYS_STATS_REQ = 0x0E  # Pull DATA_STATS
 
     # Control
     CMD_SET_STATE = 0x10
     CMD_PROFILE_LOAD = 0x11  # Updated
     CMD_HAPTIC_CFG = 0x12
-    CMD_UI_WIDGET = 0x13
-    CMD_UI_MENU = 0x14
+    CMD_UI_WIDGET = 0x13  # Widget definition, cached on the node
+    CMD_UI_MENU = 0x14  # Menu bounds for on-node hit-testing
+    CMD_PROFILE_CHUNK = 0x15
+    CMD_PROFILE_ACTIVATE = 0x16
+    CMD_TELEMETRY_CFG = 0x17  # Per-channel rate / aggregation / report-on-delta
+    CMD_OTA_BEGIN = 0x18  # Multicast firmware image announce
+    CMD_OTA_CHUNK = 0x19
+    CMD_OTA_STATUS_REQ = 0x1A  # Slotted poll for missing-chunk bitmaps
+    CMD_OTA_CTRL = 0x1B  # Apply / commit / rollback / abort
+    CMD_UI_UPDATE = 0x1C  # Changed fields of cached widgets, several per frame
 
     # Events
     EVENT_UI_INPUT = 0x20
     EVENT_CRITICAL = 0x21
     EVENT_FLOW_START = 0x22
+    EVENT_OTA_STATUS = 0x23  # OTA state + missing-chunk bitmap
+    EVENT_UI_ROTATE = 0x24  # Coalesced knob rotation
 
     # Telemetry
     DATA_SENSOR = 0x30
     DATA_MULTI = 0x31
     DATA_SCALE = 0x32
+    DATA_BLOCK = 0x33  # Delta-encoded DATA_SCALE / DATA_MULTI samples
+    DATA_AGGREGATE = 0x34  # Min / max / mean / last of one window
+    DATA_STATS = 0x35  # Link / hot-path counters and latency histograms
 
 
 # === 4. ENUMS ===
@@ -83,6 +119,25 @@ class HapticMode(IntEnum):
     SERVO = 4
 
 
+class WidgetKind(IntEnum):
+    NONE = 0  # Removes the widget
+    LABEL = 1
+    VALUE = 2  # value / 10**decimals, label as unit
+    GAUGE = 3
+    BAR = 4
+    ICON = 5
+
+
+class ErrorCode(IntEnum):
+    UNKNOWN = 0x00
+    BAD_PAYLOAD = 0x01
+    PROFILE_NOT_CACHED = 0x02  # Send the full profile
+    BUSY = 0x03
+    ROUTE_GENERATION = 0x04  # Delta base mismatch: send a full table
+    OTA_STATE = 0x05  # CMD_OTA_CTRL not valid in the node's OTA state
+    WIDGET_NOT_CACHED = 0x06  # CMD_UI_UPDATE for an undefined widget
+
+
 class InputEvent(IntEnum):
     CLICK_SHORT = 0
     CLICK_LONG = 1
@@ -95,6 +150,172 @@ class InputEvent(IntEnum):
 # === 5. PAYLOAD STRUCTURES ===
 
 
+# Precompiled layouts: unpack_from() reads bytes / bytearray / memoryview
+# in place, without slicing the payload first.
+_ACK = struct.Struct("<HI")
+_ERROR = struct.Struct("<BB")
+_DISCOVERY_RES = struct.Struct("<BBBBB6s")
+_DISCOVERY_RES_V02 = struct.Struct("<BBBBB")
+_FLOW_START = struct.Struct("<I")
+_TIME_SYNC = struct.Struct("<BIIII")
+_SCALE_DATA = struct.Struct("<IihB")
+_INPUT_EVENT = struct.Struct("<BBi")
+_RSSI_ENTRY = struct.Struct("<BbB")
+_TELEMETRY_CFG = struct.Struct("<BBBBHHHi")
+_DATA_AGGREGATE = struct.Struct("<BBHIIiiiiiB")
+_STATS_HEAD = struct.Struct("<12I36H")
+_STATS_LINK = struct.Struct("<BbbH")
+_OTA_BEGIN = struct.Struct("<BBBBIIH")
+_OTA_CHUNK = struct.Struct("<BH")
+_OTA_STATUS_REQ = struct.Struct("<BBH")
+_OTA_STATUS = struct.Struct("<BBBHH")
+_OTA_CTRL = struct.Struct("<BBI")
+_UI_MENU = struct.Struct("<BBB")
+_EVENT_ROTATE = struct.Struct("<BBhHhHi")
+_UI_WIDGET = struct.Struct("<BBBBBBBBBiii")
+
+
+@dataclass
+class PayloadAck:
+    ack_seq: int  # Next expected seq (cumulative)
+    sack_bits: int = 0  # Bit N: ack_seq + 1 + N received
+
+    def pack(self) -> bytes:
+        return _ACK.pack(self.ack_seq & 0xFFFF, self.sack_bits)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _ACK.size:
+            return None
+        return cls(*_ACK.unpack_from(data))
+
+
+@dataclass
+class PayloadError:
+    ref_msg_type: int
+    code: int  # Enum ErrorCode
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _ERROR.size:
+            return None
+        return cls(*_ERROR.unpack_from(data))
+
+
+@dataclass
+class PayloadBatch:
+    """HU_MSG_BATCH: repeated { msg_type: u8, len: u8, body }."""
+
+    records: List[Tuple[int, bytes]]
+
+    def pack(self) -> bytes:
+        out = bytearray()
+        for msg_type, body in self.records:
+            if msg_type == MsgType.BATCH:
+                raise ValueError("Nested batch")
+            out += struct.pack("<BB", msg_type, len(body))
+            out += body
+        if len(out) > HU_MAX_PAYLOAD_SIZE:
+            raise ValueError(f"Batch too large: {len(out)}")
+        return bytes(out)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        records = []
+        pos = 0
+        while pos + 2 <= len(data):
+            msg_type, n = data[pos], data[pos + 1]
+            end = pos + 2 + n
+            if end > len(data) or msg_type == MsgType.BATCH:
+                break  # Malformed tail: keep what was valid
+            records.append((msg_type, bytes(data[pos + 2 : end])))
+            pos = end
+        return cls(records)
+
+
+DISCOVERY_FILTER_BYTES = 32
+DISCOVERY_REQ_LEGACY_SLOTS = 16  # Empty v0.2 request: 16 x 6 ms, like 0..100 ms jitter
+DISCOVERY_REQ_LEGACY_SLOT_MS = 6
+
+
+def discovery_mac_hash(mac: bytes, round_no: int) -> int:
+    """FNV-1a 32 over round + MAC (matches hu_discovery_mac_hash)."""
+    h = ((2166136261 ^ (round_no & 0xFF)) * 16777619) & 0xFFFFFFFF
+    for b in mac:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+@dataclass
+class PayloadDiscoveryReq:
+    round: int = 0
+    slot_count: int = 0  # 0 counts as one slot (hu_discovery_reply_delay)
+    slot_ms: int = 0
+    seen_filter: bytearray = field(
+        default_factory=lambda: bytearray(DISCOVERY_FILTER_BYTES)
+    )
+
+    def mark_seen(self, mac: bytes):
+        """Adds mac to the Bloom filter (k = 2, hash bytes 2 and 3)."""
+        h = discovery_mac_hash(mac, self.round)
+        for bit in ((h >> 16) & 0xFF, (h >> 24) & 0xFF):
+            self.seen_filter[bit >> 3] |= 1 << (bit & 7)
+
+    def slot_of(self, mac: bytes) -> int:
+        return (discovery_mac_hash(mac, self.round) & 0xFFFF) % max(self.slot_count, 1)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        """Empty payload (v0.2 request): round 0, legacy slots, empty filter."""
+        if len(data) == 0:
+            return cls(0, DISCOVERY_REQ_LEGACY_SLOTS, DISCOVERY_REQ_LEGACY_SLOT_MS)
+        if len(data) != 3 + DISCOVERY_FILTER_BYTES:
+            return None
+        round_, slot_count, slot_ms = data[:3]
+        return cls(round_, slot_count, slot_ms, bytearray(data[3:]))
+
+    def pack(self) -> bytes:
+        return struct.pack(
+            "<BBB32s",
+            self.round,
+            self.slot_count,
+            self.slot_ms,
+            bytes(self.seen_filter),
+        )
+
+
+class DiscoverySession:
+    """Coordinator side of slotted, incremental discovery.
+
+    Each round re-seeds the hashes, so two nodes that collided in one round
+    get different slots in the next; nodes already heard stay silent.
+    """
+
+    def __init__(self, slot_count: int = 16, slot_ms: int = 8):
+        self.slot_count = slot_count
+        self.slot_ms = slot_ms
+        self.round = 0
+        self.found: Dict[bytes, "PayloadDiscoveryRes"] = {}
+
+    def next_request(self) -> PayloadDiscoveryReq:
+        self.round = (self.round + 1) & 0xFF
+        req = PayloadDiscoveryReq(self.round, self.slot_count, self.slot_ms)
+        for mac in self.found:
+            req.mark_seen(mac)
+        return req
+
+    def on_response(self, res: "PayloadDiscoveryRes") -> bool:
+        """Returns True for a node not seen before."""
+        if res.mac is None or res.mac in self.found:
+            return False
+        self.found[res.mac] = res
+        return True
+
+    @property
+    def round_ms(self) -> int:
+        return self.slot_count * self.slot_ms
+
+
 @dataclass
 class PayloadDiscoveryRes:
     device_type: int
@@ -102,12 +323,15 @@ class PayloadDiscoveryRes:
     fw_major: int
     fw_minor: int
     current_id: int
+    mac: Optional[bytes] = None  # None for v0.2 nodes without the MAC field
 
     @classmethod
     def unpack(cls, data: bytes):
-        if len(data) < 5:
+        if len(data) >= _DISCOVERY_RES.size:
+            return cls(*_DISCOVERY_RES.unpack_from(data))
+        if len(data) < _DISCOVERY_RES_V02.size:
             return None
-        return cls(*struct.unpack("<BBBBB", data[:5]))
+        return cls(*_DISCOVERY_RES_V02.unpack_from(data))
 
 
 @dataclass
@@ -119,6 +343,257 @@ class PayloadAssignID:
         return struct.pack("<6sB", self.target_mac, self.new_logical_id)
 
 
+GROUP_OP_SET = 0x00
+GROUP_OP_JOIN = 0x01
+GROUP_OP_LEAVE = 0x02
+GROUP_COUNT = DeviceAddress.MAX_GROUP - DeviceAddress.MIN_GROUP + 1
+
+
+def group_bit(addr: int) -> int:
+    return 1 << (addr - DeviceAddress.MIN_GROUP)
+
+
+@dataclass
+class PayloadGroupSet:
+    group_mask: int
+    op: int = GROUP_OP_SET
+    device_type: int = DeviceType.UNKNOWN  # Filter for broadcast provisioning
+
+    def pack(self) -> bytes:
+        return struct.pack("<BBH", self.device_type, self.op, self.group_mask)
+
+
+class GroupTable:
+    """Coordinator view of group addresses (0xF1..0xFD).
+
+    Groups are either bound to a device type (provisioned with one broadcast
+    SYS_GROUP_SET) or hold explicit members (one unicast JOIN per member).
+    """
+
+    def __init__(self):
+        self.members: Dict[int, set] = {}
+        self.by_type: Dict[int, int] = {}  # group addr -> DeviceType
+
+    def _free(self) -> int:
+        for addr in range(DeviceAddress.MIN_GROUP, DeviceAddress.MAX_GROUP + 1):
+            if addr not in self.members:
+                return addr
+        raise ValueError("No free group address")
+
+    def bind_type(self, device_type: int, nodes: Dict[int, int]):
+        """Group of every node of device_type; nodes maps id -> type.
+
+        Returns (group address, broadcast SYS_GROUP_SET payload).
+        """
+        for addr, t in self.by_type.items():
+            if t == device_type:
+                break
+        else:
+            addr = self._free()
+            self.by_type[addr] = device_type
+        self.members[addr] = {n for n, t in nodes.items() if t == device_type}
+        return addr, PayloadGroupSet(group_bit(addr), GROUP_OP_JOIN, device_type)
+
+    def create(self, node_ids: List[int]):
+        """Explicit group. Returns (address, unicast JOIN payload)."""
+        addr = self._free()
+        self.members[addr] = set(node_ids)
+        return addr, PayloadGroupSet(group_bit(addr), GROUP_OP_JOIN)
+
+    def on_node(self, node_id: int, device_type: int):
+        """A node was (re)assigned: full membership to send it, or None."""
+        mask = 0
+        for addr, members in self.members.items():
+            if self.by_type.get(addr) == device_type:
+                members.add(node_id)
+            if node_id in members:
+                mask |= group_bit(addr)
+        return PayloadGroupSet(mask) if mask else None
+
+    def vias(self, addr: int, routes: Dict[int, int]) -> List[int]:
+        """via_id values needed to reach every member of a group.
+
+        Group frames go out on the broadcast MAC, so direct members already
+        take the first copy of a relayed frame (and dedup drops the repeat):
+        one frame per distinct repeater, or a single direct frame.
+        """
+        hops = {routes.get(n, 0) for n in self.members.get(addr, ())} - {0}
+        return sorted(hops) or [0]
+
+
+ROUTE_UPDATE_FULL = 0x00
+ROUTE_UPDATE_DELTA = 0x01
+
+
+@dataclass
+class PayloadRouteUpdate:
+    """SYS_ROUTE_UPDATE: sparse (target, next_hop) list, 0 = direct."""
+
+    generation: int
+    mode: int = ROUTE_UPDATE_FULL
+    base_generation: int = 0
+    entries: List[Tuple[int, int]] = field(default_factory=list)
+
+    @classmethod
+    def full(cls, generation: int, routes: Dict[int, int]):
+        """Only relayed targets are listed; everything else is direct.
+
+        Nodes apply a FULL whatever its generation, so a gateway that has
+        restarted may start counting again from any value.
+        """
+        entries = sorted((t, hop) for t, hop in routes.items() if hop != 0)
+        return cls(generation & 0xFFFF, ROUTE_UPDATE_FULL, 0, entries)
+
+    @classmethod
+    def delta(
+        cls,
+        generation: int,
+        base_generation: int,
+        old: Dict[int, int],
+        new: Dict[int, int],
+    ):
+        """Entries whose next hop moved between two tables."""
+        targets = set(old) | set(new)
+        entries = sorted(
+            (t, new.get(t, 0)) for t in targets if old.get(t, 0) != new.get(t, 0)
+        )
+        return cls(
+            generation & 0xFFFF, ROUTE_UPDATE_DELTA, base_generation & 0xFFFF, entries
+        )
+
+    def pack(self) -> bytes:
+        payload = struct.pack("<HHB", self.generation, self.base_generation, self.mode)
+        payload += b"".join(struct.pack("<BB", t, hop) for t, hop in self.entries)
+        if len(payload) > HU_MAX_PAYLOAD_SIZE:
+            raise ValueError(f"Route update too large: {len(payload)}")
+        return payload
+
+
+RSSI_SURVEY_FULL = 0x00
+RSSI_SURVEY_INCREMENTAL = 0x01
+RSSI_DIRECT_THRESHOLD_DBM = -75  # docs/routing.md: direct link if stronger
+
+
+@dataclass
+class PayloadRssiSurvey:
+    """SYS_RSSI_SURVEY: probes[i] pings in slot i, reports in slot N + i."""
+
+    session: int
+    probes: List[int]
+    slot_ms: int = 10
+    mode: int = RSSI_SURVEY_FULL
+
+    @property
+    def duration_ms(self) -> int:
+        return 2 * len(self.probes) * self.slot_ms
+
+    def pack(self) -> bytes:
+        if len(self.probes) > 64:
+            raise ValueError(f"Too many probes: {len(self.probes)}")
+        head = struct.pack("<BBB", self.session, self.mode, self.slot_ms)
+        return head + bytes(self.probes)
+
+
+@dataclass
+class PayloadRssiReport:
+    session: int
+    entries: List[Tuple[int, int, int]]  # (src_id, rssi_dbm, samples)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < 1 or (len(data) - 1) % 3:
+            return None
+        entries = list(_RSSI_ENTRY.iter_unpack(memoryview(data)[1:]))
+        return cls(data[0], entries)
+
+
+class RssiMatrix:
+    """Link RSSI between nodes, built from survey reports.
+
+    links[(tx, rx)] holds the surveyed value (None: not heard). Live
+    readings from normal traffic are fed to observe(); a link whose live
+    value moves across the direct-link threshold is re-probed by an
+    incremental survey that lists only the endpoints of such links.
+    """
+
+    def __init__(
+        self, threshold_dbm: int = RSSI_DIRECT_THRESHOLD_DBM, hysteresis_db: int = 3
+    ):
+        self.threshold_dbm = threshold_dbm
+        self.hysteresis_db = hysteresis_db
+        self.links: Dict[Tuple[int, int], Optional[int]] = {}
+        self.live: Dict[Tuple[int, int], float] = {}
+        self.session = 0
+
+    def _next_session(self) -> int:
+        self.session = (self.session + 1) & 0xFF
+        return self.session
+
+    def survey_full(self, node_ids: List[int], slot_ms: int = 10) -> PayloadRssiSurvey:
+        return PayloadRssiSurvey(
+            self._next_session(), list(node_ids), slot_ms, RSSI_SURVEY_FULL
+        )
+
+    def apply_report(self, reporter_id: int, report: PayloadRssiReport) -> bool:
+        if report.session != self.session:
+            return False  # Late report of an older survey
+        for src_id, rssi, samples in report.entries:
+            key = (src_id, reporter_id)
+            self.links[key] = rssi if samples else None
+            self.live.pop(key, None)
+        return True
+
+    def observe(self, tx_id: int, rx_id: int, rssi_dbm: int, alpha: float = 0.25):
+        key = (tx_id, rx_id)
+        prev = self.live.get(key)
+        if prev is None:
+            self.live[key] = float(rssi_dbm)
+        else:
+            self.live[key] = prev + alpha * (rssi_dbm - prev)
+
+    def _direct(self, rssi: Optional[float], margin: float = 0) -> bool:
+        return rssi is not None and rssi > self.threshold_dbm + margin
+
+    def drifted_links(self) -> List[Tuple[int, int]]:
+        """Links whose live RSSI crossed the threshold (with hysteresis)."""
+        out = []
+        for key, live in self.live.items():
+            surveyed = self.links.get(key)
+            if self._direct(surveyed):
+                crossed = live < self.threshold_dbm - self.hysteresis_db
+            else:
+                crossed = self._direct(live, self.hysteresis_db)
+            if crossed:
+                out.append(key)
+        return sorted(out)
+
+    def survey_incremental(self, slot_ms: int = 10) -> Optional[PayloadRssiSurvey]:
+        """Survey of drifted link endpoints only, None if nothing drifted."""
+        ends = sorted({node for link in self.drifted_links() for node in link})
+        if not ends:
+            return None
+        return PayloadRssiSurvey(
+            self._next_session(), ends, slot_ms, RSSI_SURVEY_INCREMENTAL
+        )
+
+    def direct(self, a: int, b: int) -> bool:
+        """Both directions strong enough for a direct link."""
+        ab, ba = self.links.get((a, b)), self.links.get((b, a))
+        return self._direct(ab) and self._direct(ba)
+
+
+# hu_profile_node_t: H (time) B (flags) 10B (targets/tols)
+_PROFILE_NODE = struct.Struct("<HB10B")
+_PROFILE_NODE_LSB = (0.5, 0.5, 0.1, 0.1, 0.1, 0.1, 0.1, 0.1, 1, 1)
+_PROFILE_LOAD = struct.Struct("<BB")
+_PROFILE_CHUNK = struct.Struct("<BBBB")
+if np is not None:
+    _PROFILE_NODE_DTYPE = np.dtype(
+        [("time_offset_ms", "<u2"), ("config", "u1"), ("values", "u1", (10,))]
+    )
+    assert _PROFILE_NODE_DTYPE.itemsize == _PROFILE_NODE.size  # hu_profile_node_t
+
+
 @dataclass
 class PayloadProfileNode:
     time_offset_ms: int
@@ -142,32 +617,60 @@ class PayloadProfileNode:
     energy_target: int  # 0-255
     energy_tol: int
 
-    def pack(self) -> bytes:
-        # 1. Config Flags: Bits 0-1 (Interp), Bits 2-3 (Prio)
-        config = (self.interpolation & 0x03) | ((self.priority & 0x03) << 2)
+    def _config(self) -> int:
+        # Config Flags: Bits 0-1 (Interp), Bits 2-3 (Prio)
+        return (self.interpolation & 0x03) | ((self.priority & 0x03) << 2)
 
-        # 2. Scaling helper
-        def _s(val, factor):
-            i = int(round(val / factor))
-            return max(0, min(255, i))
+    def _values(self) -> Tuple[float, ...]:
+        return (
+            self.temp_target,
+            self.temp_tol,
+            self.press_target,
+            self.press_tol,
+            self.flow_in_target,
+            self.flow_in_tol,
+            self.flow_out_target,
+            self.flow_out_tol,
+            self.energy_target,
+            self.energy_tol,
+        )
 
-        # 3. Pack: H (time) B (flags) 10B (targets/tols)
-        return struct.pack(
-            "<HB BBBBBBBBBB",
-            self.time_offset_ms,
-            config,
-            _s(self.temp_target, 0.5),
-            _s(self.temp_tol, 0.5),
-            _s(self.press_target, 0.1),
-            _s(self.press_tol, 0.1),
-            _s(self.flow_in_target, 0.1),
-            _s(self.flow_in_tol, 0.1),
-            _s(self.flow_out_target, 0.1),
-            _s(self.flow_out_tol, 0.1),
-            _s(self.energy_target, 1),
-            _s(self.energy_tol, 1),
+    def _fields(self) -> Tuple[int, ...]:
+        scaled = [round(v / lsb) for v, lsb in zip(self._values(), _PROFILE_NODE_LSB)]
+        return (self.time_offset_ms, self._config()) + tuple(
+            0 if i < 0 else 255 if i > 255 else i for i in scaled
         )
 
+    def pack(self) -> bytes:
+        return _PROFILE_NODE.pack(*self._fields())
+
+    def pack_into(self, buf, offset: int = 0) -> int:
+        """Writes the node at buf[offset:], returns the bytes written."""
+        _PROFILE_NODE.pack_into(buf, offset, *self._fields())
+        return _PROFILE_NODE.size
+
+
+def _pack_nodes_into(buf, offset: int, nodes: List[PayloadProfileNode]) -> int:
+    if np is not None and nodes:
+        # One divide / round / clip over nodes x 10 values; same IEEE
+        # quotients and round-half-even as _fields()
+        values = np.array([n._values() for n in nodes], dtype=np.float64)
+        times = [n.time_offset_ms for n in nodes]
+        if np.isfinite(values).all() and 0 <= min(times) and max(times) <= 0xFFFF:
+            rec = np.empty(len(nodes), dtype=_PROFILE_NODE_DTYPE)
+            rec["time_offset_ms"] = times
+            rec["config"] = [n._config() for n in nodes]
+            rec["values"] = np.clip(np.rint(values / _PROFILE_NODE_LSB), 0, 255)
+            end = offset + rec.nbytes
+            buf[offset:end] = rec.tobytes()
+            return end
+        # Out-of-range input: the struct path below raises as usual
+    pack_into = _PROFILE_NODE.pack_into
+    for node in nodes:
+        pack_into(buf, offset, *node._fields())
+        offset += _PROFILE_NODE.size
+    return offset
+
 
 @dataclass
 class PayloadProfileLoad:
@@ -175,13 +678,290 @@ class PayloadProfileLoad:
     nodes: List[PayloadProfileNode]
 
     def pack(self) -> bytes:
-        if len(self.nodes) > 17:
-            raise ValueError(f"Too many nodes: {len(self.nodes)} > 17")
+        buf = bytearray(self.packed_size())
+        self.pack_into(buf)
+        return bytes(buf)
 
-        payload = struct.pack("<BB", self.profile_id, len(self.nodes))
-        for node in self.nodes:
-            payload += node.pack()
-        return payload
+    def packed_size(self) -> int:
+        return _PROFILE_LOAD.size + len(self.nodes) * _PROFILE_NODE.size
+
+    def pack_into(self, buf, offset: int = 0) -> int:
+        """Writes header + nodes at buf[offset:], returns the bytes written."""
+        if len(self.nodes) > PROFILE_LOAD_NODES:
+            raise ValueError(
+                f"Too many nodes: {len(self.nodes)} > {PROFILE_LOAD_NODES}"
+                " (use chunks())"
+            )
+        _PROFILE_LOAD.pack_into(buf, offset, self.profile_id, len(self.nodes))
+        end = _pack_nodes_into(buf, offset + _PROFILE_LOAD.size, self.nodes)
+        return end - offset
+
+    def chunks(self, upload_id: int) -> List["PayloadProfileChunk"]:
+        """Split into CMD_PROFILE_CHUNK payloads (no 17-node limit).
+
+        upload_id must differ from the previous upload to this node (e.g. a
+        counter & 0xFF): any chunk with a new upload_id restarts assembly.
+        """
+        total = len(self.nodes)
+        if total > PROFILE_MAX_NODES:
+            raise ValueError(f"Too many nodes: {total} > {PROFILE_MAX_NODES}")
+        return [
+            PayloadProfileChunk(
+                profile_id=self.profile_id,
+                upload_id=upload_id,
+                total_nodes=total,
+                first_node=first,
+                nodes=self.nodes[first : first + PROFILE_CHUNK_NODES],
+            )
+            for first in range(0, total, PROFILE_CHUNK_NODES)
+        ]
+
+
+# Nodes per CMD_PROFILE_LOAD / CMD_PROFILE_CHUNK frame (17 each)
+PROFILE_LOAD_NODES = (HU_MAX_PAYLOAD_SIZE - _PROFILE_LOAD.size) // _PROFILE_NODE.size
+PROFILE_CHUNK_NODES = (HU_MAX_PAYLOAD_SIZE - _PROFILE_CHUNK.size) // _PROFILE_NODE.size
+PROFILE_MAX_NODES = 64  # Node-side buffer (HU_PROFILE_MAX_NODES)
+
+
+@dataclass
+class PayloadProfileChunk:
+    profile_id: int
+    upload_id: int  # Same for all chunks of one upload
+    total_nodes: int
+    first_node: int
+    nodes: List[PayloadProfileNode]
+
+    def pack(self) -> bytes:
+        buf = bytearray(self.packed_size())
+        self.pack_into(buf)
+        return bytes(buf)
+
+    def packed_size(self) -> int:
+        return _PROFILE_CHUNK.size + len(self.nodes) * _PROFILE_NODE.size
+
+    def pack_into(self, buf, offset: int = 0) -> int:
+        """Writes header + nodes at buf[offset:], returns the bytes written."""
+        if len(self.nodes) > PROFILE_CHUNK_NODES:
+            raise ValueError(
+                f"Too many nodes in chunk: {len(self.nodes)} > {PROFILE_CHUNK_NODES}"
+            )
+        _PROFILE_CHUNK.pack_into(
+            buf,
+            offset,
+            self.profile_id,
+            self.upload_id,
+            self.total_nodes,
+            self.first_node,
+        )
+        end = _pack_nodes_into(buf, offset + _PROFILE_CHUNK.size, self.nodes)
+        return end - offset
+
+
+def profile_hash(nodes: List[PayloadProfileNode]) -> int:
+    """FNV-1a 32 over the packed nodes (matches hu_profile_hash)."""
+    buf = bytearray(len(nodes) * _PROFILE_NODE.size)
+    _pack_nodes_into(buf, 0, nodes)
+    h = 2166136261
+    for b in buf:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+@dataclass
+class PayloadProfileActivate:
+    profile_id: int
+    total_nodes: int
+    content_hash: int
+    start_at_ms: int = 0  # Network time, 0 = on receipt
+
+    @classmethod
+    def for_profile(cls, profile: PayloadProfileLoad, start_at_ms: int = 0):
+        return cls(
+            profile.profile_id,
+            len(profile.nodes),
+            profile_hash(profile.nodes),
+            start_at_ms,
+        )
+
+    def pack(self) -> bytes:
+        return struct.pack(
+            "<BBII",
+            self.profile_id,
+            self.total_nodes,
+            self.content_hash,
+            self.start_at_ms,
+        )
+
+
+@dataclass
+class PayloadSetState:
+    channel: int
+    state: int
+    execute_at_ms: int = 0  # Network time, 0 = on receipt
+
+    def pack(self) -> bytes:
+        return struct.pack("<BBI", self.channel, self.state, self.execute_at_ms)
+
+
+@dataclass
+class PayloadFlowStart:
+    timestamp_ms: int  # Network time
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _FLOW_START.size:
+            return None
+        return cls(*_FLOW_START.unpack_from(data))
+
+
+TELEMETRY_MODE_RAW = 0x00
+TELEMETRY_MODE_AGGREGATE = 0x01
+TELEMETRY_MODE_ON_DELTA = 0x02
+TELEMETRY_ALL_CHANNELS = 0xFF
+
+
+@dataclass
+class PayloadTelemetryCfg:
+    """CMD_TELEMETRY_CFG: subscription for one source / channel.
+
+    Several entries go out in one PayloadBatch; addressed to a group they
+    switch, e.g., all sensors between idle and shot rates.
+    """
+
+    source_type: int  # MsgType.DATA_SCALE / DATA_MULTI / DATA_SENSOR
+    channel: int = TELEMETRY_ALL_CHANNELS
+    mode: int = TELEMETRY_MODE_RAW
+    period_ms: int = 1000  # 0 = off
+    decimation: int = 1  # RAW: every Nth sample
+    window_ms: int = 0  # AGGREGATE
+    heartbeat_ms: int = 0  # ON_DELTA: longest silence, 0 = none
+    delta_threshold: int = 0  # ON_DELTA
+
+    @classmethod
+    def raw(
+        cls, source_type, channel=TELEMETRY_ALL_CHANNELS, period_ms=1000, decimation=1
+    ):
+        return cls(source_type, channel, TELEMETRY_MODE_RAW, period_ms, decimation)
+
+    @classmethod
+    def aggregate(
+        cls, source_type, window_ms, channel=TELEMETRY_ALL_CHANNELS, period_ms=100
+    ):
+        return cls(
+            source_type,
+            channel,
+            TELEMETRY_MODE_AGGREGATE,
+            period_ms,
+            window_ms=window_ms,
+        )
+
+    @classmethod
+    def on_delta(
+        cls,
+        source_type,
+        threshold,
+        channel=TELEMETRY_ALL_CHANNELS,
+        period_ms=100,
+        heartbeat_ms=5000,
+    ):
+        return cls(
+            source_type,
+            channel,
+            TELEMETRY_MODE_ON_DELTA,
+            period_ms,
+            heartbeat_ms=heartbeat_ms,
+            delta_threshold=threshold,
+        )
+
+    def pack(self) -> bytes:
+        return _TELEMETRY_CFG.pack(
+            self.source_type,
+            self.channel,
+            self.mode,
+            self.decimation,
+            self.period_ms,
+            self.window_ms,
+            self.heartbeat_ms,
+            self.delta_threshold,
+        )
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _TELEMETRY_CFG.size:
+            return None
+        src, ch, mode, decim, period, window, hb, thr = _TELEMETRY_CFG.unpack_from(data)
+        return cls(src, ch, mode, period, decim, window, hb, thr)
+
+
+def telemetry_batch(cfgs: List[PayloadTelemetryCfg]) -> List[bytes]:
+    """CMD_TELEMETRY_CFG entries as HU_MSG_BATCH payloads (one per frame)."""
+    per_frame = HU_MAX_PAYLOAD_SIZE // (2 + _TELEMETRY_CFG.size)
+    return [
+        PayloadBatch(
+            [(MsgType.CMD_TELEMETRY_CFG, c.pack()) for c in cfgs[i : i + per_frame]]
+        ).pack()
+        for i in range(0, len(cfgs), per_frame)
+    ]
+
+
+TIME_SYNC_PROBE = 0x00
+TIME_SYNC_ECHO = 0x01
+TIME_SYNC_FOLLOW_UP = 0x02
+
+
+@dataclass
+class PayloadTimeSync:
+    kind: int
+    t1: int = 0
+    t2: int = 0
+    t3: int = 0
+    t4: int = 0
+
+    def pack(self) -> bytes:
+        return _TIME_SYNC.pack(self.kind, self.t1, self.t2, self.t3, self.t4)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _TIME_SYNC.size:
+            return None
+        return cls(*_TIME_SYNC.unpack_from(data))
+
+
+def _s32(v: int) -> int:
+    v &= 0xFFFFFFFF
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+class TimeSyncServer:
+    """Coordinator side of SYS_TIME_SYNC; the RPi clock is network time.
+
+    probe() -> send to node; on_echo() -> FOLLOW_UP to send back. The
+    per-node offset/RTT estimate is kept here too, for diagnostics and for
+    choosing an execute-at lead time.
+    """
+
+    def __init__(self):
+        self.offset_ms: Dict[int, int] = {}
+        self.rtt_ms: Dict[int, int] = {}
+
+    @staticmethod
+    def probe(now_ms: int) -> PayloadTimeSync:
+        return PayloadTimeSync(TIME_SYNC_PROBE, now_ms & 0xFFFFFFFF)
+
+    def on_echo(
+        self, node_id: int, echo: PayloadTimeSync, now_ms: int
+    ) -> PayloadTimeSync:
+        t4 = now_ms & 0xFFFFFFFF
+        rtt = _s32(t4 - echo.t1) - _s32(echo.t3 - echo.t2)
+        offset = (_s32(echo.t2 - echo.t1) + _s32(echo.t3 - t4)) / 2
+        self.rtt_ms[node_id] = rtt
+        self.offset_ms[node_id] = round(offset)
+        return PayloadTimeSync(TIME_SYNC_FOLLOW_UP, echo.t1, echo.t2, echo.t3, t4)
+
+    def start_time(self, now_ms: int, node_ids: List[int], margin_ms: int = 10) -> int:
+        """Network time far enough ahead for every node to get its command."""
+        worst = max((self.rtt_ms.get(n, 0) for n in node_ids), default=0)
+        return (now_ms + worst + margin_ms) & 0xFFFFFFFF or 1
 
 
 @dataclass
@@ -197,6 +977,152 @@ class PayloadHapticConfig:
         )
 
 
+MENU_WRAP = 0x01
+
+
+@dataclass
+class PayloadUiMenu:
+    """Menu bounds: one detent per item, hit-tested on the knob."""
+
+    item_count: int  # 0 = no menu
+    selected: int = 0
+    flags: int = 0  # MENU_*
+
+    def pack(self) -> bytes:
+        return _UI_MENU.pack(self.item_count, self.selected, self.flags)
+
+
+WIDGET_MAX = 32  # Node cache slots (HU_WIDGET_MAX)
+WIDGET_LABEL_MAX = 16
+WIDGET_VISIBLE = 0x01
+WIDGET_HIGHLIGHT = 0x02
+WIDGET_BLINK = 0x04
+
+
+@dataclass
+class PayloadUiWidget:
+    """CMD_UI_WIDGET: full definition, cached on the node by widget_id."""
+
+    widget_id: int
+    kind: int  # WidgetKind
+    x: int = 0
+    y: int = 0
+    w: int = 0
+    h: int = 0
+    color: int = 0  # Palette index
+    flags: int = WIDGET_VISIBLE
+    decimals: int = 0
+    value: int = 0
+    min: int = 0
+    max: int = 0
+    label: bytes = b""  # UTF-8
+
+    def pack(self) -> bytes:
+        if not 0 <= self.widget_id < WIDGET_MAX:
+            raise ValueError(f"widget_id out of range: {self.widget_id}")
+        if len(self.label) > WIDGET_LABEL_MAX:
+            raise ValueError(f"Widget label too long: {len(self.label)}")
+        return (
+            _UI_WIDGET.pack(
+                self.widget_id,
+                self.kind,
+                self.x,
+                self.y,
+                self.w,
+                self.h,
+                self.color,
+                self.flags,
+                self.decimals,
+                self.value,
+                self.min,
+                self.max,
+            )
+            + self.label
+        )
+
+
+UI_DIRTY_VALUE = 0x01
+UI_DIRTY_VALUE16 = 0x02
+UI_DIRTY_FLAGS = 0x04
+UI_DIRTY_COLOR = 0x08
+UI_DIRTY_RANGE = 0x10
+UI_DIRTY_RECT = 0x20
+UI_DIRTY_LABEL = 0x40
+
+
+@dataclass
+class UiFieldUpdate:
+    """One CMD_UI_UPDATE record: the fields that are not None."""
+
+    widget_id: int
+    value: Optional[int] = None  # Sent as VALUE16 when it fits
+    flags: Optional[int] = None
+    color: Optional[int] = None
+    range: Optional[Tuple[int, int]] = None  # min, max
+    rect: Optional[Tuple[int, int, int, int]] = None  # x, y, w, h
+    label: Optional[bytes] = None
+
+    def pack(self) -> bytes:
+        dirty = 0
+        body = b""
+        if self.value is not None:
+            if -0x8000 <= self.value <= 0x7FFF:
+                dirty |= UI_DIRTY_VALUE16
+                body += struct.pack("<h", self.value)
+            else:
+                dirty |= UI_DIRTY_VALUE
+                body += struct.pack("<i", self.value)
+        if self.flags is not None:
+            dirty |= UI_DIRTY_FLAGS
+            body += bytes([self.flags])
+        if self.color is not None:
+            dirty |= UI_DIRTY_COLOR
+            body += bytes([self.color])
+        if self.range is not None:
+            dirty |= UI_DIRTY_RANGE
+            body += struct.pack("<ii", *self.range)
+        if self.rect is not None:
+            dirty |= UI_DIRTY_RECT
+            body += bytes(self.rect)
+        if self.label is not None:
+            if len(self.label) > WIDGET_LABEL_MAX:
+                raise ValueError(f"Widget label too long: {len(self.label)}")
+            dirty |= UI_DIRTY_LABEL
+            body += bytes([len(self.label)]) + self.label
+        return bytes([self.widget_id, dirty]) + body
+
+
+def ui_update(records: List[bytes]) -> bytes:
+    """CMD_UI_UPDATE payload from packed UiFieldUpdate records."""
+    payload = bytes([len(records)]) + b"".join(records)
+    if len(records) > 0xFF or len(payload) > HU_MAX_PAYLOAD_SIZE:
+        raise ValueError(f"UI update too large: {len(payload)}")
+    return payload
+
+
+ROTATE_MENU = 0x01  # position is the selected menu item
+ROTATE_AT_LIMIT = 0x02  # Pushed against a barrier / menu bound
+
+
+@dataclass
+class PayloadEventRotate:
+    """EVENT_UI_ROTATE: rotation coalesced over window_ms."""
+
+    source_index: int
+    flags: int  # ROTATE_*
+    delta: int  # Net steps
+    steps: int  # Steps in either direction
+    velocity: int  # Net steps per second
+    window_ms: int
+    position: int  # Absolute step / menu item
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _EVENT_ROTATE.size:
+            return None
+        return cls(*_EVENT_ROTATE.unpack_from(data))
+
+
 @dataclass
 class PayloadScaleData:
     timestamp_ms: int
@@ -206,9 +1132,295 @@ class PayloadScaleData:
 
     @classmethod
     def unpack(cls, data: bytes):
-        if len(data) < 11:
+        if len(data) < _SCALE_DATA.size:
+            return None
+        return cls(*_SCALE_DATA.unpack_from(data))
+
+
+BLOCK_HAS_B = 0x01
+_BLOCK_HEADER = struct.Struct("<BBBBHIiiB")
+
+
+def _read_varint(data, pos: int) -> Tuple[int, int]:
+    result = 0
+    shift = 0
+    while shift < 35:
+        byte = data[pos]
+        pos += 1
+        result |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return result, pos
+        shift += 7
+    raise ValueError("Varint too long")
+
+
+def _unzigzag(v: int) -> int:
+    return (v >> 1) ^ -(v & 1)
+
+
+def _wrap_i32(v: int) -> int:
+    return ((v + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+
+
+@dataclass
+class PayloadDataBlock:
+    """HU_MSG_DATA_BLOCK: base sample + zigzag varint deltas."""
+
+    source_type: int  # MsgType.DATA_SCALE / MsgType.DATA_MULTI
+    channel: int
+    interval_ms: int
+    status: int
+    samples: List[Tuple[int, int, int]]  # (timestamp_ms, a, b)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _BLOCK_HEADER.size:
+            return None
+        head = _BLOCK_HEADER.unpack_from(data)
+        src, channel, flags, count, interval, ts, a, b, status = head
+        has_b = bool(flags & BLOCK_HAS_B)
+        samples = [(ts, a, b)]
+        pos = _BLOCK_HEADER.size
+        try:
+            for _ in range(count - 1):
+                d, pos = _read_varint(data, pos)
+                a = _wrap_i32(a + _unzigzag(d))
+                if has_b:
+                    d, pos = _read_varint(data, pos)
+                    b = _wrap_i32(b + _unzigzag(d))
+                ts += interval
+                samples.append((ts, a, b))
+        except (IndexError, ValueError):
+            pass  # Truncated block: keep the samples decoded so far
+        return cls(src, channel, interval, status, samples)
+
+    def to_scale_data(self) -> List["PayloadScaleData"]:
+        """Expand a DATA_SCALE block into per-sample PayloadScaleData."""
+        return [PayloadScaleData(ts, a, b, self.status) for ts, a, b in self.samples]
+
+
+@dataclass
+class PayloadDataAggregate:
+    """HU_MSG_DATA_AGGREGATE: statistics of `a` over one window."""
+
+    source_type: int
+    channel: int
+    count: int
+    start_ms: int
+    end_ms: int
+    min_a: int
+    max_a: int
+    mean_a: int
+    last_a: int
+    last_b: int
+    status: int
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _DATA_AGGREGATE.size:
+            return None
+        return cls(*_DATA_AGGREGATE.unpack_from(data))
+
+
+STATS_REQ_RESET = 0x01
+STATS_HIST_BUCKETS = 12
+STATS_HIST_NAMES = ("forward", "tx_queue", "ack_rtt")
+STATS_COUNTERS = (
+    "rx_frames",
+    "rx_bad",
+    "rx_bad_crc",
+    "rx_duplicates",
+    "rx_overflow",
+    "forwarded",
+    "forward_failed",
+    "tx_frames",
+    "tx_retries",
+    "tx_dropped",
+)
+
+
+def stats_bucket_ms(k: int) -> Tuple[int, Optional[int]]:
+    """[low, high) ms of histogram bucket k; high None for the last one."""
+    if k == 0:
+        return 0, 1
+    high = 1 << k if k < STATS_HIST_BUCKETS - 1 else None
+    return 1 << (k - 1), high
+
+
+@dataclass
+class PayloadStatsReq:
+    flags: int = STATS_REQ_RESET
+
+    def pack(self) -> bytes:
+        return struct.pack("<B", self.flags)
+
+
+@dataclass
+class StatsLink:
+    peer_id: int
+    rssi_avg_dbm: int
+    rssi_min_dbm: int
+    frames: int
+
+
+@dataclass
+class PayloadStats:
+    """HU_MSG_DATA_STATS. Counters are cumulative (wrap at 2^32);
+    histograms and links cover interval_ms."""
+
+    uptime_ms: int
+    interval_ms: int
+    counters: Dict[str, int]
+    hist: Dict[str, List[int]]  # STATS_HIST_NAMES -> bucket counts
+    links: List[StatsLink] = field(default_factory=list)
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _STATS_HEAD.size:
+            return None
+        values = _STATS_HEAD.unpack_from(data)
+        counters = dict(zip(STATS_COUNTERS, values[2:12]))
+        buckets = values[12:]
+        hist = {
+            name: list(buckets[i * STATS_HIST_BUCKETS : (i + 1) * STATS_HIST_BUCKETS])
+            for i, name in enumerate(STATS_HIST_NAMES)
+        }
+        links = [
+            StatsLink(*_STATS_LINK.unpack_from(data, pos))
+            for pos in range(_STATS_HEAD.size, len(data) - 4, _STATS_LINK.size)
+        ]
+        return cls(values[0], values[1], counters, hist, links)
+
+
+OTA_CHUNK_SIZE = 224  # Image bytes per CMD_OTA_CHUNK (HU_OTA_CHUNK_SIZE)
+OTA_MAX_CHUNKS = 8192  # Node bitmap capacity (HU_OTA_MAX_CHUNKS)
+OTA_BITMAP_MAX = HU_MAX_PAYLOAD_SIZE - _OTA_STATUS.size  # Bitmap bytes per report
+
+
+class OtaState(IntEnum):
+    IDLE = 0x00
+    RECEIVING = 0x01
+    COMPLETE = 0x02
+    FAILED = 0x03
+    PENDING_VERIFY = 0x04
+
+
+class OtaError(IntEnum):
+    NONE = 0x00
+    SIZE = 0x01
+    PREPARE = 0x02
+    WRITE = 0x03
+    VERIFY = 0x04
+
+
+class OtaOp(IntEnum):
+    APPLY = 0x00  # Boot the new image at execute_at_ms (Pending Verify)
+    COMMIT = 0x01
+    ROLLBACK = 0x02
+    ABORT = 0x03
+
+
+@dataclass
+class PayloadOtaBegin:
+    session: int
+    device_type: int
+    fw_major: int
+    fw_minor: int
+    image_size: int
+    image_crc32: int  # zlib.crc32 of the image
+
+    @property
+    def chunk_count(self) -> int:
+        return (self.image_size + OTA_CHUNK_SIZE - 1) // OTA_CHUNK_SIZE
+
+    def pack(self) -> bytes:
+        if not 0 < self.chunk_count <= OTA_MAX_CHUNKS:
+            raise ValueError(f"Image size out of range: {self.image_size}")
+        return _OTA_BEGIN.pack(
+            self.session,
+            self.device_type,
+            self.fw_major,
+            self.fw_minor,
+            self.image_size,
+            self.image_crc32,
+            self.chunk_count,
+        )
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) != _OTA_BEGIN.size:
+            return None
+        return cls(*_OTA_BEGIN.unpack_from(data)[:6])
+
+
+def ota_chunk(session: int, image, index: int) -> bytes:
+    """CMD_OTA_CHUNK payload for chunk `index` of image (bytes-like)."""
+    offset = index * OTA_CHUNK_SIZE
+    data = image[offset : offset + OTA_CHUNK_SIZE]
+    buf = bytearray(_OTA_CHUNK.size + len(data))
+    _OTA_CHUNK.pack_into(buf, 0, session, index)
+    buf[_OTA_CHUNK.size :] = data
+    return bytes(buf)
+
+
+@dataclass
+class PayloadOtaStatusReq:
+    """CMD_OTA_STATUS_REQ: probes[i] answers at i * slot_ms; no probes on a
+    unicast request means an immediate reply."""
+
+    session: int
+    from_chunk: int = 0
+    probes: List[int] = field(default_factory=list)
+    slot_ms: int = 10
+
+    @property
+    def duration_ms(self) -> int:
+        return max(1, len(self.probes)) * self.slot_ms
+
+    def pack(self) -> bytes:
+        head = _OTA_STATUS_REQ.pack(self.session, self.slot_ms, self.from_chunk)
+        return head + bytes(self.probes)
+
+
+@dataclass
+class PayloadOtaStatus:
+    session: int
+    state: int  # OtaState
+    error: int  # OtaError
+    missing: int  # Chunks missing in the whole image
+    base: int
+    bitmap: bytes = b""
+
+    @classmethod
+    def unpack(cls, data: bytes):
+        if len(data) < _OTA_STATUS.size:
             return None
-        return cls(*struct.unpack("<IihB", data[:11]))
+        return cls(*_OTA_STATUS.unpack_from(data), bytes(data[_OTA_STATUS.size :]))
+
+    def missing_chunks(self) -> List[int]:
+        """Chunk numbers flagged in the bitmap."""
+        out = []
+        for i, byte in enumerate(self.bitmap):
+            while byte:
+                low = byte & -byte
+                out.append(self.base + 8 * i + low.bit_length() - 1)
+                byte ^= low
+        return out
+
+    @property
+    def reported_end(self) -> int:
+        """First chunk past the bitmap (poll again from here if needed)."""
+        return self.base + 8 * len(self.bitmap)
+
+
+@dataclass
+class PayloadOtaCtrl:
+    session: int
+    op: int  # OtaOp
+    execute_at_ms: int = 0  # Network time, 0 = on receipt
+
+    def pack(self) -> bytes:
+        return _OTA_CTRL.pack(self.session, self.op, self.execute_at_ms)
 
 
 @dataclass
@@ -219,14 +1431,37 @@ class PayloadInputEvent:
 
     @classmethod
     def unpack(cls, data: bytes):
-        if len(data) < 6:
+        if len(data) < _INPUT_EVENT.size:
             return None
-        return cls(*struct.unpack("<BBi", data[:6]))
+        return cls(*_INPUT_EVENT.unpack_from(data))
 
 
 # === 6. MAIN FRAME ===
 
 _HEADER_STRUCT = struct.Struct("<BBBBBBHB")
+_CRC = struct.Struct("<H")
+
+
+def _crc16_table() -> List[int]:
+    table = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = (c >> 1) ^ 0x8408 if c & 1 else c >> 1
+        table.append(c)
+    return table
+
+
+_CRC16_TABLE = _crc16_table()
+
+
+def crc16(data: bytes, crc: int = 0) -> int:
+    """CRC-16/X-25, chainable (matches hu_crc16 / esp_rom_crc16_le)."""
+    crc ^= 0xFFFF
+    table = _CRC16_TABLE
+    for b in data:
+        crc = table[(crc ^ b) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFF
 
 
 @dataclass
@@ -240,36 +1475,83 @@ class MeshFrame:
     flags: int = 0
 
     def pack(self) -> bytes:
-        if len(self.payload) > HU_MAX_PAYLOAD_SIZE:
-            raise ValueError(f"Payload too large: {len(self.payload)}")
+        return bytes(
+            self.pack_payload(
+                self.src_id,
+                self.dst_id,
+                self.msg_type,
+                self.payload,
+                seq_num=self.seq_num,
+                flags=self.flags,
+                via_id=self.via_id,
+            )
+        )
+
+    @staticmethod
+    def pack_payload(
+        src_id: int,
+        dst_id: int,
+        msg_type: int,
+        payload,
+        seq_num: int = 0,
+        flags: int = 0,
+        via_id: int = 0,
+    ) -> bytearray:
+        """Builds a complete frame in one buffer.
+
+        payload is bytes-like or an object with packed_size() / pack_into()
+        (PayloadProfileLoad, PayloadProfileChunk): header, payload and CRC
+        trailer are then written in place, with no intermediate bytes.
+        """
+        if hasattr(payload, "pack_into"):
+            p_len = payload.packed_size()
+        else:
+            p_len = len(payload)
+        if p_len > HU_MAX_PAYLOAD_SIZE:
+            raise ValueError(f"Payload too large: {p_len}")
 
-        header = _HEADER_STRUCT.pack(
+        body_end = HEADER_SIZE + p_len
+        buf = bytearray(body_end + (CRC_SIZE if flags & FLAG_CRC else 0))
+        _HEADER_STRUCT.pack_into(
+            buf,
+            0,
             HU_PROTOCOL_MAGIC,
-            self.flags,
-            self.src_id,
-            self.dst_id,
-            self.via_id,
-            self.msg_type,
-            self.seq_num,
-            len(self.payload),
+            flags,
+            src_id,
+            dst_id,
+            via_id,
+            msg_type,
+            seq_num,
+            p_len,
         )
-        return header + self.payload
+        if hasattr(payload, "pack_into"):
+            payload.pack_into(buf, HEADER_SIZE)
+        else:
+            buf[HEADER_SIZE:body_end] = payload
+        if flags & FLAG_CRC:
+            _CRC.pack_into(buf, body_end, crc16(memoryview(buf)[:body_end]))
+        return buf
 
     @classmethod
     def unpack(cls, data: bytes) -> Tuple[Optional["MeshFrame"], bytes]:
         if len(data) < HEADER_SIZE:
             return None, data
 
-        magic, flags, src, dst, via, msg_type, seq, p_len = _HEADER_STRUCT.unpack(
-            data[:HEADER_SIZE]
+        magic, flags, src, dst, via, msg_type, seq, p_len = _HEADER_STRUCT.unpack_from(
+            data
         )
 
         if magic != HU_PROTOCOL_MAGIC:
             return None, data[1:]
 
         total_len = HEADER_SIZE + p_len
-        if len(data) < total_len:
+        end = total_len + (CRC_SIZE if flags & FLAG_CRC else 0)
+        if len(data) < end:
             return None, data
+        if flags & FLAG_CRC:
+            (crc,) = _CRC.unpack_from(data, total_len)
+            if crc != crc16(data[:total_len]):
+                return None, data[1:]  # Corrupted: resync at the next byte
 
         frame = cls(
             src_id=src,
@@ -280,4 +1562,228 @@ class MeshFrame:
             seq_num=seq,
             flags=flags,
         )
-        return frame, data[total_len:]
+        return frame, data[end:]
+
+
+_MAGIC_BYTE = bytes([HU_PROTOCOL_MAGIC])
+
+
+class FrameDecoder:
+    """Incremental decoder for a raw frame byte stream.
+
+    feed() appends to one bytearray and walks it with an offset; consumed
+    bytes are dropped once per call (del from the front of a bytearray does
+    not copy the tail). Garbage is skipped with find() to the next magic,
+    so the cost is linear in the bytes received. Only each payload is
+    copied, into its MeshFrame.
+
+    For the COBS tunnel use TunnelDecoder and MeshFrame.unpack per record.
+    """
+
+    def __init__(self):
+        self._buf = bytearray()
+        self.frames = 0
+        self.skipped_bytes = 0  # Resync: bytes that were not part of a frame
+        self.bad_crc = 0
+
+    def feed(self, data) -> List[MeshFrame]:
+        buf = self._buf
+        buf += data
+        out: List[MeshFrame] = []
+        n = len(buf)
+        pos = 0
+        while n - pos >= HEADER_SIZE:
+            if buf[pos] != HU_PROTOCOL_MAGIC:
+                nxt = buf.find(_MAGIC_BYTE, pos + 1)
+                if nxt < 0:
+                    nxt = n
+                self.skipped_bytes += nxt - pos
+                pos = nxt
+                continue
+            _, flags, src, dst, via, msg_type, seq, p_len = _HEADER_STRUCT.unpack_from(
+                buf, pos
+            )
+            if p_len > HU_MAX_PAYLOAD_SIZE:
+                self.skipped_bytes += 1
+                pos += 1
+                continue
+            body_end = pos + HEADER_SIZE + p_len
+            end = body_end + (CRC_SIZE if flags & FLAG_CRC else 0)
+            if end > n:
+                break  # Incomplete: wait for more bytes
+            if flags & FLAG_CRC:
+                (crc,) = _CRC.unpack_from(buf, body_end)
+                if crc != crc16(buf[pos:body_end]):
+                    self.bad_crc += 1
+                    self.skipped_bytes += 1
+                    pos += 1
+                    continue
+            out.append(
+                MeshFrame(
+                    src_id=src,
+                    dst_id=dst,
+                    msg_type=msg_type,
+                    payload=bytes(buf[pos + HEADER_SIZE : body_end]),
+                    via_id=via,
+                    seq_num=seq,
+                    flags=flags,
+                )
+            )
+            pos = end
+        del buf[:pos]
+        self.frames += len(out)
+        return out
+
+    @property
+    def pending(self) -> int:
+        """Bytes held back as an incomplete frame."""
+        return len(self._buf)
+
+
+# === 7. SERIAL TUNNEL (dongle <-> RPi, src/c/hu_tunnel.h) ===
+
+TUNNEL_DELIMITER = 0x00
+TUNNEL_MAX_RAW = 1024
+TUNNEL_KIND_MESH = 0x01
+
+_TUNNEL_HEADER = struct.Struct("<BBB")
+_TUNNEL_RECORD = struct.Struct("<BbI")
+
+
+def cobs_encode(data: bytes) -> bytes:
+    out = bytearray()
+    pos = 0
+    n = len(data)
+    while True:
+        # Block: up to 254 non-zero bytes, ended by a zero or the input end
+        zero = data.find(b"\x00", pos, pos + 254)
+        end = zero if zero >= 0 else min(pos + 254, n)
+        out.append(end - pos + 1)
+        out += data[pos:end]
+        if zero >= 0:
+            pos = zero + 1
+        elif end - pos == 254:
+            pos = end
+            if pos == n:
+                out.append(1)  # Same trailing code as hu_cobs_encode
+                break
+        else:
+            break
+    return bytes(out)
+
+
+def cobs_decode(data: bytes) -> Optional[bytes]:
+    """Decodes one packet without delimiter; None if malformed."""
+    out = bytearray()
+    pos = 0
+    n = len(data)
+    while pos < n:
+        code = data[pos]
+        end = pos + code
+        if code == 0 or end > n:
+            return None
+        out += data[pos + 1 : end]
+        pos = end
+        if code != 0xFF and pos < n:
+            out.append(0)
+    return bytes(out)
+
+
+@dataclass
+class TunnelRecord:
+    frame: bytes  # Raw mesh frame (MeshFrame.unpack)
+    rssi_dbm: int = 0
+    rx_us: int = 0  # Dongle clock
+
+
+class TunnelEncoder:
+    """Packs mesh frames into COBS link packets, several per packet."""
+
+    def __init__(self):
+        self.seq = 0
+
+    def encode(self, frames: List[bytes]) -> bytes:
+        """Returns the bytes for one write(): as many packets as needed."""
+        out = bytearray()
+        start = 0
+        while start < len(frames):
+            raw = bytearray(_TUNNEL_HEADER.pack(TUNNEL_KIND_MESH, self.seq, 0))
+            count = 0
+            for frame in frames[start:]:
+                need = _TUNNEL_RECORD.size + len(frame)
+                if count == 255 or len(raw) + need + CRC_SIZE > TUNNEL_MAX_RAW:
+                    break
+                raw += _TUNNEL_RECORD.pack(len(frame), 0, 0) + frame
+                count += 1
+            if count == 0:
+                raise ValueError(f"Frame too large: {len(frames[start])}")
+            raw[2] = count
+            raw += struct.pack("<H", crc16(raw))
+            out += cobs_encode(bytes(raw))
+            out.append(TUNNEL_DELIMITER)
+            self.seq = (self.seq + 1) & 0xFF
+            start += count
+        return bytes(out)
+
+
+class TunnelDecoder:
+    """Stream decoder for the gateway: feed() whatever read() returned.
+
+    Splitting on the delimiter and COBS decoding both work on whole slices,
+    never one byte per Python call.
+    """
+
+    def __init__(self):
+        self._buf = bytearray()
+        self._next_seq: Optional[int] = None
+        self.packets = 0
+        self.bad_packets = 0
+        self.lost_packets = 0
+
+    def feed(self, data: bytes) -> List[TunnelRecord]:
+        self._buf += data
+        records: List[TunnelRecord] = []
+        start = 0
+        while True:
+            end = self._buf.find(b"\x00", start)
+            if end < 0:
+                break
+            if end > start:
+                self._packet(bytes(self._buf[start:end]), records)
+            start = end + 1
+        del self._buf[:start]
+        if len(self._buf) > 2 * TUNNEL_MAX_RAW:
+            self._buf.clear()  # No delimiter in sight: garbage
+            self.bad_packets += 1
+        return records
+
+    def _packet(self, encoded: bytes, records: List[TunnelRecord]):
+        raw = cobs_decode(encoded)
+        if raw is None or len(raw) < _TUNNEL_HEADER.size + CRC_SIZE:
+            self.bad_packets += 1
+            return
+        body = raw[:-CRC_SIZE]
+        (crc,) = struct.unpack_from("<H", raw, len(body))
+        kind, seq, count = _TUNNEL_HEADER.unpack_from(body)
+        if crc != crc16(body) or kind != TUNNEL_KIND_MESH:
+            self.bad_packets += 1
+            return
+
+        out = []
+        pos = _TUNNEL_HEADER.size
+        for _ in range(count):
+            if pos + _TUNNEL_RECORD.size > len(body):
+                break
+            length, rssi, rx_us = _TUNNEL_RECORD.unpack_from(body, pos)
+            pos += _TUNNEL_RECORD.size
+            out.append(TunnelRecord(body[pos : pos + length], rssi, rx_us))
+            pos += length
+        if len(out) != count or pos != len(body):
+            self.bad_packets += 1
+            return
+
+        if self._next_seq is not None:
+            self.lost_packets += (seq - self._next_seq) & 0xFF
+        self._next_seq = (seq + 1) & 0xFF
+        self.packets += 1
+        records.extend(out)
@@ -0,0 +1,212 @@
+"""Gateway-side encode / decode microbenchmarks.
+
+    python -m cd_protocol.bench
+    python -m cd_protocol.bench --filter frame --save base.txt
+    python -m cd_protocol.bench --baseline base.txt
+
+Each benchmark is timed with timeit (autorange, then best of --repeat runs)
+on fixed inputs and reported per operation, one line each, in the format
+shared with the on-target suite (src/c/hu_bench.h):
+
+    BENCH py.<name> <ns_per_op> ns/op
+
+With --baseline, lines of an earlier run are read back and the change is
+appended as (+x.x%); --max-regress makes the exit status fail on a slowdown.
+"""
+
+import argparse
+import timeit
+from typing import Callable, Dict, List, Optional, Tuple
+
+from . import (
+    _SCALE_DATA,
+    FLAG_CRC,
+    DeviceAddress,
+    FrameDecoder,
+    MeshFrame,
+    MsgType,
+    PayloadProfileLoad,
+    PayloadProfileNode,
+    PayloadScaleData,
+    TunnelDecoder,
+    TunnelEncoder,
+    crc16,
+    profile_hash,
+)
+from .columnar import decode_scale_batch
+
+STREAM_FRAMES = 64  # Frames per feed() call: one busy serial read
+BATCH_SAMPLES = 1000  # Payloads per columnar decode
+
+# name -> (setup returning the timed callable, operations per call)
+Bench = Tuple[Callable[[], Callable[[], object]], int]
+
+
+def _scale_frames(count: int) -> List[bytes]:
+    return [
+        MeshFrame.pack_payload(
+            0x10 + k % 15,
+            DeviceAddress.COORDINATOR,
+            MsgType.DATA_SCALE,
+            _SCALE_DATA.pack(10 * k, 18000 + k, 1500, 0),
+            seq_num=k,
+            flags=FLAG_CRC,
+        )
+        for k in range(count)
+    ]
+
+
+def _profile_nodes() -> List[PayloadProfileNode]:
+    return [
+        PayloadProfileNode(
+            time_offset_ms=2000 * i,
+            priority=0 if i < 4 else 1,
+            interpolation=1,
+            temp_target=93.0,
+            temp_tol=2.0,
+            press_target=2.0 + i * 0.5,
+            press_tol=0.5,
+            flow_in_target=4.0,
+            flow_in_tol=0.5,
+            flow_out_target=1.8,
+            flow_out_tol=0.4,
+            energy_target=100 + i,
+            energy_tol=10,
+        )
+        for i in range(17)
+    ]
+
+
+def _frame_unpack():
+    frame = bytes(_scale_frames(1)[0])
+    return lambda: MeshFrame.unpack(frame)
+
+
+def _frame_pack():
+    payload = _SCALE_DATA.pack(1000, 18000, 1500, 0)
+    frame = MeshFrame(
+        0x10, DeviceAddress.COORDINATOR, MsgType.DATA_SCALE, payload, flags=FLAG_CRC
+    )
+    return frame.pack
+
+
+def _decoder_feed():
+    stream = b"".join(_scale_frames(STREAM_FRAMES))
+    decoder = FrameDecoder()
+    return lambda: decoder.feed(stream)
+
+
+def _tunnel_feed():
+    stream = TunnelEncoder().encode([bytes(f) for f in _scale_frames(STREAM_FRAMES)])
+    decoder = TunnelDecoder()
+    return lambda: decoder.feed(stream)
+
+
+def _crc16_max():
+    data = bytes(range(239))
+    return lambda: crc16(data)
+
+
+def _scale_unpack():
+    payload = _SCALE_DATA.pack(1000, 18000, 1500, 0)
+    return lambda: PayloadScaleData.unpack(payload)
+
+
+def _scale_columnar():
+    payloads = [_SCALE_DATA.pack(k, 18000 + k, 1500, 0) for k in range(BATCH_SAMPLES)]
+    return lambda: decode_scale_batch(payloads)
+
+
+def _profile_pack():
+    load = PayloadProfileLoad(profile_id=1, nodes=_profile_nodes())
+    return load.pack
+
+
+def _profile_hash():
+    nodes = _profile_nodes()
+    return lambda: profile_hash(nodes)
+
+
+BENCHES: Dict[str, Bench] = {
+    "frame_unpack": (_frame_unpack, 1),
+    "frame_pack": (_frame_pack, 1),
+    "decoder_feed": (_decoder_feed, STREAM_FRAMES),
+    "tunnel_feed": (_tunnel_feed, STREAM_FRAMES),
+    "crc16_239": (_crc16_max, 1),
+    "scale_unpack": (_scale_unpack, 1),
+    "scale_columnar": (_scale_columnar, BATCH_SAMPLES),
+    "profile_pack": (_profile_pack, 1),
+    "profile_hash": (_profile_hash, 1),
+}
+
+
+def run(name: str, repeat: int = 5) -> float:
+    """Best-of-repeat time of one benchmark, ns per operation."""
+    setup, ops = BENCHES[name]
+    timer = timeit.Timer(setup())
+    number, _ = timer.autorange()
+    best = min(timer.repeat(repeat=repeat, number=number))
+    return best / number / ops * 1e9
+
+
+def format_line(name: str, ns_per_op: float) -> str:
+    return f"BENCH py.{name} {ns_per_op:.1f} ns/op"
+
+
+def parse_lines(lines) -> Dict[str, float]:
+    """BENCH lines (any suite) -> {"py.name": value}; other lines ignored."""
+    out: Dict[str, float] = {}
+    for line in lines:
+        parts = line.split()
+        if len(parts) >= 4 and parts[0] == "BENCH":
+            try:
+                out[parts[1]] = float(parts[2])
+            except ValueError:
+                continue
+    return out
+
+
+def main(argv=None) -> int:
+    ap = argparse.ArgumentParser(prog="python -m cd_protocol.bench")
+    ap.add_argument("--filter", default="", help="only names containing this")
+    ap.add_argument("--repeat", type=int, default=5)
+    ap.add_argument("--save", metavar="FILE", help="also write the lines to FILE")
+    ap.add_argument("--baseline", metavar="FILE", help="earlier output to compare")
+    ap.add_argument(
+        "--max-regress",
+        type=float,
+        metavar="PCT",
+        help="exit 1 if any benchmark is slower than the baseline by more",
+    )
+    args = ap.parse_args(argv)
+
+    base: Dict[str, float] = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            base = parse_lines(f)
+
+    lines: List[str] = []
+    worst: Optional[float] = None
+    for name in BENCHES:
+        if args.filter not in name:
+            continue
+        ns = run(name, args.repeat)
+        line = format_line(name, ns)
+        lines.append(line)
+        old = base.get(f"py.{name}")
+        if old:
+            change = (ns / old - 1.0) * 100.0
+            worst = change if worst is None else max(worst, change)
+            line += f" ({change:+.1f}%)"
+        print(line, flush=True)
+
+    if args.save:
+        with open(args.save, "w") as f:
+            f.write("\n".join(lines) + "\n")
+    if args.max_regress is not None and worst is not None:
+        return 1 if worst > args.max_regress else 0
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,189 @@
+"""Append-only capture files of mesh traffic (.cdcap).
+
+Layout (little endian):
+
+    file header   magic "CDCP", version: u16, reserved: u16, t0_unix_us: u64
+    record        ts_us: u64, flags: u8, rssi_dbm: i8, len: u16, frame[len]
+
+ts_us counts from t0_unix_us (gateway capture clock). frame is the raw mesh
+frame as received, header first (hu_frame_header_t), CRC trailer included.
+Records are only ever appended; a torn last record after a crash is ignored
+by the reader. The reader mmaps the file and copies out one frame at a
+time, so a long capture is scanned without reading it into memory.
+"""
+
+import mmap
+import os
+import struct
+import time
+from dataclasses import dataclass
+from typing import Iterator, Optional, Tuple
+
+from . import _SCALE_DATA, DeviceAddress, MeshFrame, MsgType
+
+CAPTURE_MAGIC = b"CDCP"
+CAPTURE_VERSION = 1
+CAPTURE_SUFFIX = ".cdcap"
+
+CAPTURE_TX = 0x01  # Frame sent by the gateway (otherwise received)
+
+_FILE_HEADER = struct.Struct("<4sHHQ")
+_RECORD = struct.Struct("<QBbH")
+_LEN = struct.Struct("<H")  # Last field of _RECORD
+
+
+@dataclass
+class CaptureRecord:
+    ts_us: int
+    flags: int
+    rssi_dbm: int
+    frame: bytes
+
+    @property
+    def direction_tx(self) -> bool:
+        return bool(self.flags & CAPTURE_TX)
+
+
+class CaptureWriter:
+    """Appends frames to a capture file (creates it with a header).
+
+    append=False starts the file over.
+    """
+
+    def __init__(
+        self, path: str, t0_unix_us: Optional[int] = None, append: bool = True
+    ):
+        if append and os.path.exists(path) and os.path.getsize(path) > 0:
+            with CaptureReader(path) as r:
+                self.t0_unix_us = r.t0_unix_us
+                end = r.valid_end()
+            self._f = open(path, "r+b")
+            self._f.truncate(end)  # Drop a torn record: appends stay readable
+            self._f.seek(end)
+        else:
+            if t0_unix_us is None:
+                t0_unix_us = time.time_ns() // 1000
+            self.t0_unix_us = t0_unix_us
+            self._f = open(path, "wb")
+            self._f.write(
+                _FILE_HEADER.pack(CAPTURE_MAGIC, CAPTURE_VERSION, 0, t0_unix_us)
+            )
+        # Monotonic capture clock, anchored so that ts_us 0 is t0_unix_us
+        elapsed_us = time.time_ns() // 1000 - self.t0_unix_us
+        self._mono0 = time.monotonic_ns() // 1000 - elapsed_us
+        self.records = 0
+
+    def now_us(self) -> int:
+        return time.monotonic_ns() // 1000 - self._mono0
+
+    def write(
+        self,
+        frame: bytes,
+        rssi_dbm: int = 0,
+        flags: int = 0,
+        ts_us: Optional[int] = None,
+    ):
+        if ts_us is None:
+            ts_us = self.now_us()
+        self._f.write(_RECORD.pack(ts_us, flags, rssi_dbm, len(frame)))
+        self._f.write(frame)
+        self.records += 1
+
+    def write_frame(self, frame: MeshFrame, rssi_dbm: int = 0, flags: int = 0):
+        self.write(frame.pack(), rssi_dbm, flags)
+
+    def flush(self):
+        self._f.flush()
+
+    def close(self):
+        self._f.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class CaptureReader:
+    """mmap-backed iterator over the records of a capture file."""
+
+    def __init__(self, path: str):
+        self._f = open(path, "rb")
+        size = os.fstat(self._f.fileno()).st_size
+        if size < _FILE_HEADER.size:
+            self._f.close()
+            raise ValueError(f"Not a capture file: {path}")
+        self._map = mmap.mmap(self._f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, _, self.t0_unix_us = _FILE_HEADER.unpack_from(self._map)
+        if magic != CAPTURE_MAGIC or version != CAPTURE_VERSION:
+            self.close()
+            raise ValueError(f"Not a capture file: {path}")
+        self.truncated = False  # Torn record at the end
+
+    def _scan(self) -> Iterator[Tuple[int, int]]:
+        view = self._map
+        end = len(view)
+        pos = _FILE_HEADER.size
+        while pos + _RECORD.size <= end:
+            (n,) = _LEN.unpack_from(view, pos + _RECORD.size - _LEN.size)
+            start = pos + _RECORD.size
+            if start + n > end:
+                break
+            yield pos, start + n
+            pos = start + n
+        self.truncated = pos != end
+
+    def __iter__(self) -> Iterator[CaptureRecord]:
+        view = self._map
+        for pos, end in self._scan():
+            ts_us, flags, rssi, _ = _RECORD.unpack_from(view, pos)
+            yield CaptureRecord(ts_us, flags, rssi, view[pos + _RECORD.size : end])
+
+    def valid_end(self) -> int:
+        """Offset just past the last complete record."""
+        end = _FILE_HEADER.size
+        for _, end in self._scan():
+            pass
+        return end
+
+    def close(self):
+        self._map.close()
+        self._f.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def synthesize_scale_load(
+    path: str,
+    nodes: int = 15,
+    rate_hz: int = 100,
+    seconds: float = 10.0,
+    first_id: int = 0x10,
+) -> int:
+    """Writes a deterministic DATA_SCALE load: `nodes` senders at rate_hz,
+    evenly phased inside each period. Returns the number of frames."""
+    period_us = 1_000_000 // rate_hz
+    count = int(seconds * rate_hz)
+    frames = 0
+    with CaptureWriter(path, t0_unix_us=0, append=False) as w:
+        for k in range(count):
+            for n in range(nodes):
+                ts_us = k * period_us + n * period_us // nodes
+                ts_ms = ts_us // 1000
+                weight = 1000 * k + n
+                payload = _SCALE_DATA.pack(ts_ms, weight, 1000, 0)
+                frame = MeshFrame(
+                    src_id=first_id + n,
+                    dst_id=DeviceAddress.COORDINATOR,
+                    msg_type=MsgType.DATA_SCALE,
+                    payload=payload,
+                    seq_num=k & 0xFFFF,
+                ).pack()
+                w.write(frame, rssi_dbm=-50 - n, ts_us=ts_us)
+                frames += 1
+    return frames
@@ -0,0 +1,210 @@
+"""Batch decode of telemetry payloads into columnar arrays.
+
+All payloads of one type are joined into a single buffer and decoded in one
+pass. With NumPy the result is a structured array whose dtype matches the
+packed C layout (fields are zero-copy column views); without it, the columns
+are array.array objects filled from struct.iter_unpack.
+"""
+
+import struct
+from array import array
+from typing import Dict, Iterable, List, Tuple
+
+from . import (
+    _BLOCK_HEADER,
+    _INPUT_EVENT,
+    _SCALE_DATA,
+    BLOCK_HAS_B,
+    MsgType,
+)
+
+try:
+    import numpy as np
+except ImportError:  # pragma: no cover - optional dependency
+    np = None
+
+# === 1. LAYOUTS (hu_payload_*_t, little endian, packed) ===
+
+# (field, struct code, array typecode)
+SCALE_FIELDS = (
+    ("timestamp_ms", "I", "I"),
+    ("weight_mg", "i", "i"),
+    ("flow_mg_s", "h", "h"),
+    ("status", "B", "B"),
+)
+INPUT_FIELDS = (
+    ("source_index", "B", "B"),
+    ("event_type", "B", "B"),
+    ("value", "i", "i"),
+)
+# DATA_BLOCK samples: a / b are wider than DATA_SCALE fields
+BLOCK_FIELDS = (
+    ("channel", "B", "B"),
+    ("timestamp_ms", "I", "I"),
+    ("a", "i", "i"),
+    ("b", "i", "i"),
+)
+
+
+def _dtype(fields):
+    if np is None:
+        return None
+    return np.dtype([(name, "<" + code) for name, code, _ in fields])
+
+
+SCALE_DTYPE = _dtype(SCALE_FIELDS)
+INPUT_DTYPE = _dtype(INPUT_FIELDS)
+BLOCK_DTYPE = _dtype(BLOCK_FIELDS)
+
+if np is not None:
+    assert SCALE_DTYPE.itemsize == _SCALE_DATA.size  # hu_payload_scale_data_t
+    assert INPUT_DTYPE.itemsize == _INPUT_EVENT.size  # hu_payload_event_input_t
+
+
+# === 2. COLUMNS ===
+
+
+class Columns:
+    """Named columns of equal length.
+
+    columns["weight_mg"] / columns.weight_mg is a NumPy array (a view into
+    one structured array) or an array.array. skipped counts payloads whose
+    size did not match the layout.
+    """
+
+    def __init__(self, data: Dict[str, object], length: int, skipped: int = 0):
+        self._data = data
+        self._length = length
+        self.skipped = skipped
+
+    def __len__(self) -> int:
+        return self._length
+
+    def __getitem__(self, name: str):
+        return self._data[name]
+
+    def __getattr__(self, name: str):
+        try:
+            return self.__dict__["_data"][name]
+        except KeyError:
+            raise AttributeError(name) from None
+
+    @property
+    def names(self) -> List[str]:
+        return list(self._data)
+
+
+def _join_exact(payloads: Iterable[bytes], size: int) -> Tuple[bytes, int]:
+    good = []
+    skipped = 0
+    for p in payloads:
+        if len(p) == size:
+            good.append(p)
+        else:
+            skipped += 1
+    return b"".join(good), skipped
+
+
+def _decode_fixed(payloads, fields, dtype, layout: struct.Struct) -> Columns:
+    buf, skipped = _join_exact(payloads, layout.size)
+    n = len(buf) // layout.size
+    if np is not None:
+        rec = np.frombuffer(buf, dtype=dtype)
+        return Columns({name: rec[name] for name, _, _ in fields}, n, skipped)
+    if n == 0:
+        cols = [()] * len(fields)
+    else:
+        cols = list(zip(*layout.iter_unpack(buf)))
+    data = {name: array(tc, col) for (name, _, tc), col in zip(fields, cols)}
+    return Columns(data, n, skipped)
+
+
+# === 3. DECODERS ===
+
+
+def decode_scale_batch(payloads: Iterable[bytes]) -> Columns:
+    """DATA_SCALE payloads -> timestamp_ms, weight_mg, flow_mg_s, status."""
+    return _decode_fixed(payloads, SCALE_FIELDS, SCALE_DTYPE, _SCALE_DATA)
+
+
+def decode_input_batch(payloads: Iterable[bytes]) -> Columns:
+    """EVENT_UI_INPUT payloads -> source_index, event_type, value."""
+    return _decode_fixed(payloads, INPUT_FIELDS, INPUT_DTYPE, _INPUT_EVENT)
+
+
+def _zigzag_varints(data: bytes, pos: int, limit: int) -> array:
+    """At most limit signed varint deltas from data[pos:].
+
+    Stops at a truncated or over-long varint, like _read_varint().
+    """
+    out = array("q")
+    if limit <= 0:
+        return out
+    d = 0
+    shift = 0
+    for byte in data[pos:]:
+        d |= (byte & 0x7F) << shift
+        if byte & 0x80:
+            shift += 7
+            if shift >= 35:
+                break
+            continue
+        out.append((d >> 1) ^ -(d & 1))
+        if len(out) == limit:
+            break
+        d = 0
+        shift = 0
+    return out
+
+
+def _block_into(data: bytes, channel, ts, a, b) -> None:
+    """Appends the samples of one DATA_BLOCK (header already checked).
+
+    Same result as PayloadDataBlock.unpack(): a truncated block keeps the
+    samples decoded so far.
+    """
+    _, ch, flags, count, interval, t, va, vb, _ = _BLOCK_HEADER.unpack_from(data)
+    step = 2 if flags & BLOCK_HAS_B else 1
+    deltas = _zigzag_varints(data, _BLOCK_HEADER.size, (count - 1) * step)
+    samples = 1 + len(deltas) // step
+    ts.append(t)
+    a.append(va)
+    b.append(vb)
+    for k in range(0, (samples - 1) * step, step):
+        va = ((va + deltas[k] + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+        if step == 2:
+            vb = ((vb + deltas[k + 1] + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+        t = (t + interval) & 0xFFFFFFFF
+        ts.append(t)
+        a.append(va)
+        b.append(vb)
+    channel.extend(array("B", (ch,)) * samples)
+
+
+def decode_block_batch(
+    payloads: Iterable[bytes], source_type: int = MsgType.DATA_SCALE
+) -> Columns:
+    """DATA_BLOCK payloads of one source_type -> channel, timestamp_ms, a, b.
+
+    For DATA_SCALE, a = weight_mg and b = flow_mg_s; for DATA_MULTI, a is the
+    value of sensor `channel`. The zigzag varint deltas are decoded straight
+    into the columns, without PayloadDataBlock or per-sample tuples.
+    """
+    channel, ts, a, b = array("B"), array("I"), array("i"), array("i")
+    skipped = 0
+    for p in payloads:
+        if len(p) < _BLOCK_HEADER.size or p[0] != source_type:
+            skipped += 1
+            continue
+        _block_into(p, channel, ts, a, b)
+    n = len(ts)
+    if np is not None:
+        rec = np.empty(n, dtype=BLOCK_DTYPE)
+        rec["channel"] = np.frombuffer(channel, dtype=np.uint8)
+        rec["timestamp_ms"] = np.frombuffer(ts, dtype=np.uint32)
+        rec["a"] = np.frombuffer(a, dtype=np.int32)
+        rec["b"] = np.frombuffer(b, dtype=np.int32)
+        data = {name: rec[name] for name, _, _ in BLOCK_FIELDS}
+    else:
+        data = {"channel": channel, "timestamp_ms": ts, "a": a, "b": b}
+    return Columns(data, n, skipped)
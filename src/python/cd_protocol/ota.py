@@ -0,0 +1,184 @@
+"""Gateway side of the multicast firmware update (CMD_OTA_* / EVENT_OTA_STATUS).
+
+One OtaSession distributes one image to every node of one device type:
+
+    s = OtaSession(image, session=7, device_type=DeviceType.BOILER_PID,
+                   fw=(0, 3), nodes=[0x10, 0x11, 0x12])
+    send(group, CMD_OTA_BEGIN, s.begin())      # repeat until no node is IDLE
+    while not s.done:
+        for payload in s.round_chunks():        # CMD_OTA_CHUNK, paced, no ACK
+            send(group, CMD_OTA_CHUNK, payload)
+        send(group, CMD_OTA_STATUS_REQ, s.status_request().pack())
+        for node_id, payload in replies:        # EVENT_OTA_STATUS
+            follow_up = s.on_status(node_id, payload)
+            if follow_up: send(node_id, CMD_OTA_STATUS_REQ, follow_up.pack())
+    send(group, CMD_OTA_CTRL, s.ctrl(OtaOp.APPLY, execute_at_ms))
+
+The first round sends every chunk once; later rounds only the union of the
+chunks some node still misses. Then the usual Pending Verify flow: after the
+reboot the nodes report PENDING_VERIFY, and the RPi sends COMMIT if every
+critical node is back (or ROLLBACK).
+
+A node that stays silent for silent_rounds rounds is given up (timed_out),
+and the session ends after max_rounds rounds in any case. A FAILED node
+is restarted on the same session with retry():
+
+    send(node_id, CMD_OTA_BEGIN, s.retry(node_id))
+"""
+
+import zlib
+from typing import Dict, Iterator, List, Optional, Set, Tuple
+
+from . import (
+    OTA_BITMAP_MAX,
+    OtaState,
+    PayloadOtaBegin,
+    PayloadOtaCtrl,
+    PayloadOtaStatus,
+    PayloadOtaStatusReq,
+    ota_chunk,
+)
+
+
+class OtaSession:
+    def __init__(
+        self,
+        image: bytes,
+        session: int,
+        device_type: int,
+        fw: Tuple[int, int],
+        nodes: List[int],
+        slot_ms: int = 10,
+        max_rounds: int = 50,
+        silent_rounds: int = 3,
+    ):
+        self.image = bytes(image)
+        self.header = PayloadOtaBegin(
+            session=session & 0xFF,
+            device_type=device_type,
+            fw_major=fw[0],
+            fw_minor=fw[1],
+            image_size=len(self.image),
+            image_crc32=zlib.crc32(self.image),
+        )
+        self.header.pack()  # Validates the size
+        self.slot_ms = slot_ms
+        self.max_rounds = max_rounds
+        self.silent_rounds = silent_rounds
+        self.status: Dict[int, Optional[PayloadOtaStatus]] = {n: None for n in nodes}
+        self._heard: Dict[int, int] = {n: 0 for n in nodes}  # Round of last status
+        self._pending: Set[int] = set(range(self.header.chunk_count))
+        self.rounds = 0
+        self.chunks_sent = 0
+
+    @property
+    def session(self) -> int:
+        return self.header.session
+
+    @property
+    def chunk_count(self) -> int:
+        return self.header.chunk_count
+
+    def begin(self) -> bytes:
+        return self.header.pack()
+
+    def _nodes_in(self, *states: int) -> List[int]:
+        return [
+            n for n, st in self.status.items() if st is not None and st.state in states
+        ]
+
+    @property
+    def waiting(self) -> List[int]:
+        """Nodes not reporting yet, or IDLE: they missed OTA_BEGIN."""
+        return [
+            n
+            for n, st in self.status.items()
+            if st is None or st.state == OtaState.IDLE
+        ]
+
+    @property
+    def failed(self) -> List[int]:
+        return self._nodes_in(OtaState.FAILED)
+
+    @property
+    def complete(self) -> List[int]:
+        return self._nodes_in(OtaState.COMPLETE, OtaState.PENDING_VERIFY)
+
+    def _finished(self, node_id: int) -> bool:
+        st = self.status[node_id]
+        return st is not None and st.state in (
+            OtaState.COMPLETE,
+            OtaState.FAILED,
+            OtaState.PENDING_VERIFY,
+        )
+
+    @property
+    def timed_out(self) -> List[int]:
+        """Unfinished nodes without a status for silent_rounds rounds."""
+        return [
+            n
+            for n, heard in self._heard.items()
+            if not self._finished(n) and self.rounds - heard >= self.silent_rounds
+        ]
+
+    @property
+    def done(self) -> bool:
+        """Every node reported COMPLETE or FAILED, or timed out; or max_rounds."""
+        if self.rounds >= self.max_rounds:
+            return True
+        silent = set(self.timed_out)
+        return all(self._finished(n) or n in silent for n in self.status)
+
+    def retry(self, node_id: int) -> bytes:
+        """Starts node_id over: forgets its status, resends every chunk.
+
+        Returns the CMD_OTA_BEGIN payload that re-arms the node (a FAILED
+        node accepts the same session again).
+        """
+        if node_id not in self.status:
+            raise ValueError(f"Node {node_id:#04x} is not in this session")
+        self.status[node_id] = None
+        self._heard[node_id] = self.rounds
+        self._pending.update(range(self.chunk_count))
+        return self.begin()
+
+    def round_chunks(self) -> Iterator[bytes]:
+        """CMD_OTA_CHUNK payloads of the next round, in image order."""
+        chunks = sorted(self._pending)
+        self._pending.clear()
+        self.rounds += 1
+        for index in chunks:
+            self.chunks_sent += 1
+            yield ota_chunk(self.session, self.image, index)
+
+    def status_request(self) -> PayloadOtaStatusReq:
+        """Slotted poll of every node that is not finished yet."""
+        probes = [
+            n
+            for n, st in self.status.items()
+            if st is None or st.state in (OtaState.IDLE, OtaState.RECEIVING)
+        ]
+        return PayloadOtaStatusReq(self.session, 0, probes, self.slot_ms)
+
+    def on_status(self, node_id: int, payload: bytes) -> Optional[PayloadOtaStatusReq]:
+        """Merges one EVENT_OTA_STATUS into the next round.
+
+        Returns a unicast follow-up request if the bitmap was full, i.e. the
+        node may miss more chunks past it.
+        """
+        st = PayloadOtaStatus.unpack(payload)
+        if st is None or st.session != self.session or node_id not in self.status:
+            return None
+        self.status[node_id] = st
+        self._heard[node_id] = self.rounds
+        if st.state != OtaState.RECEIVING:
+            return None
+        flagged = st.missing_chunks()
+        self._pending.update(c for c in flagged if c < self.chunk_count)
+        if len(st.bitmap) == OTA_BITMAP_MAX and st.reported_end < self.chunk_count:
+            return PayloadOtaStatusReq(self.session, st.reported_end)
+        return None
+
+    def ctrl(self, op: int, execute_at_ms: int = 0) -> bytes:
+        """CMD_OTA_CTRL payload (OtaOp.APPLY / COMMIT / ROLLBACK / ABORT)."""
+        return PayloadOtaCtrl(self.session, op, execute_at_ms).pack()
@@ -0,0 +1,108 @@
+"""Gateway side of SYS_STATS_REQ / DATA_STATS: polling and MQTT export.
+
+The gateway sends PayloadStatsReq (with STATS_REQ_RESET) to every node each
+period, so every DATA_STATS carries histograms for exactly one period.
+StatsCollector turns the cumulative counters into per-period deltas and rates,
+derives latency percentiles from the log2 histograms and returns
+(topic, JSON) pairs for the MQTT client:
+
+    <prefix>/<node_id>          counters, rates, p50 / p99 per histogram
+    <prefix>/<node_id>/links    RSSI and frame count per previous hop
+"""
+
+import json
+from typing import Dict, List, Optional, Tuple
+
+from . import (
+    STATS_COUNTERS,
+    STATS_REQ_RESET,
+    PayloadStats,
+    PayloadStatsReq,
+    stats_bucket_ms,
+)
+
+DEFAULT_TOPIC_PREFIX = "cd/mesh/stats"
+
+
+def hist_percentile(buckets: List[int], q: float) -> Optional[int]:
+    """Upper bound (ms) of the bucket holding quantile q; None if empty.
+
+    The open last bucket reports its lower bound.
+    """
+    total = sum(buckets)
+    if total == 0:
+        return None
+    rank = q * total
+    seen = 0
+    for k, n in enumerate(buckets):
+        seen += n
+        if seen >= rank and n:
+            low, high = stats_bucket_ms(k)
+            return high if high is not None else low
+    return None
+
+
+class StatsCollector:
+    def __init__(self, topic_prefix: str = DEFAULT_TOPIC_PREFIX):
+        self.topic_prefix = topic_prefix
+        self._last: Dict[int, PayloadStats] = {}
+
+    @staticmethod
+    def request() -> bytes:
+        """SYS_STATS_REQ payload for one poll (starts a new interval)."""
+        return PayloadStatsReq(STATS_REQ_RESET).pack()
+
+    def forget(self, node_id: int):
+        """Node rebooted / was re-addressed: next report is a new baseline."""
+        self._last.pop(node_id, None)
+
+    def on_stats(self, node_id: int, payload: bytes) -> List[Tuple[str, str]]:
+        stats = PayloadStats.unpack(payload)
+        if stats is None:
+            return []
+        prev = self._last.get(node_id)
+        if prev is not None and stats.uptime_ms < prev.uptime_ms:
+            prev = None  # Rebooted: counters restarted
+        self._last[node_id] = stats
+
+        seconds = stats.interval_ms / 1000.0
+        doc = {
+            "node": node_id,
+            "uptime_ms": stats.uptime_ms,
+            "interval_ms": stats.interval_ms,
+            "counters": stats.counters,
+        }
+        if prev is not None:
+            delta = {
+                name: (stats.counters[name] - prev.counters[name]) & 0xFFFFFFFF
+                for name in STATS_COUNTERS
+            }
+            doc["delta"] = delta
+            if seconds > 0:
+                doc["rate_per_s"] = {
+                    name: round(n / seconds, 2) for name, n in delta.items()
+                }
+        doc["latency_ms"] = {
+            name: {
+                "p50": hist_percentile(buckets, 0.50),
+                "p99": hist_percentile(buckets, 0.99),
+                "count": sum(buckets),
+                "buckets": buckets,
+            }
+            for name, buckets in stats.hist.items()
+        }
+
+        topic = f"{self.topic_prefix}/{node_id}"
+        out = [(topic, json.dumps(doc, separators=(",", ":")))]
+        if stats.links:
+            links = [
+                {
+                    "peer": link.peer_id,
+                    "rssi_avg_dbm": link.rssi_avg_dbm,
+                    "rssi_min_dbm": link.rssi_min_dbm,
+                    "frames": link.frames,
+                }
+                for link in stats.links
+            ]
+            out.append((topic + "/links", json.dumps(links, separators=(",", ":"))))
+        return out
@@ -0,0 +1,131 @@
+"""Gateway side of the knob widget cache (CMD_UI_WIDGET / CMD_UI_UPDATE).
+
+WidgetSync holds what each widget should show and sends only what changed:
+
+    ui = WidgetSync()
+    send(knob, CMD_UI_WIDGET, ui.define(PayloadUiWidget(0, WidgetKind.VALUE,
+         x=40, y=90, w=160, h=60, decimals=1, label=b"bar")))    # with ACK
+    ...
+    ui.set(0, value=round(pressure_bar * 10))                    # any rate
+    for payload in ui.frames(now_ms):                            # every 50 ms
+        send(knob, CMD_UI_UPDATE, payload)                       # no ACK
+    ...
+    for payload in ui.on_error(error_payload):                   # node rebooted
+        send(knob, CMD_UI_WIDGET, payload)
+
+Values set between two ticks merge into one record, so a readout sampled at
+100 Hz still costs one 4-byte record per tick. Updates travel without ACK:
+every refresh_ms the value, flags and color of every widget are sent again,
+which heals a lost frame (labels, ranges and rects change rarely; define()
+them again when they must not be lost).
+"""
+
+from dataclasses import replace
+from typing import Dict, List, Optional
+
+from . import (
+    HU_MAX_PAYLOAD_SIZE,
+    ErrorCode,
+    MsgType,
+    PayloadError,
+    PayloadUiWidget,
+    UiFieldUpdate,
+    WidgetKind,
+    ui_update,
+)
+
+# set() keyword -> record field
+_GROUPS = {
+    "value": "value",
+    "flags": "flags",
+    "color": "color",
+    "min": "range",
+    "max": "range",
+    "x": "rect",
+    "y": "rect",
+    "w": "rect",
+    "h": "rect",
+    "label": "label",
+}
+_REFRESHED = ("value", "flags", "color")
+
+
+class WidgetSync:
+    def __init__(self, refresh_ms: int = 1000):
+        self.refresh_ms = refresh_ms
+        self.widgets: Dict[int, PayloadUiWidget] = {}
+        self._dirty: Dict[int, set] = {}
+        self._refreshed_ms: Optional[int] = None
+
+    def define(self, widget: PayloadUiWidget) -> bytes:
+        """CMD_UI_WIDGET payload; the definition replaces pending changes."""
+        payload = widget.pack()
+        self.widgets[widget.widget_id] = replace(widget)
+        self._dirty.pop(widget.widget_id, None)
+        return payload
+
+    def remove(self, widget_id: int) -> bytes:
+        """CMD_UI_WIDGET payload that removes the widget on the node."""
+        self.widgets.pop(widget_id, None)
+        self._dirty.pop(widget_id, None)
+        return PayloadUiWidget(widget_id, WidgetKind.NONE).pack()
+
+    def set(self, widget_id: int, **fields) -> None:
+        """Changes fields of a defined widget; unchanged values are not sent."""
+        w = self.widgets[widget_id]
+        for name, value in fields.items():
+            group = _GROUPS[name]  # KeyError: not an updatable field
+            if getattr(w, name) != value:
+                setattr(w, name, value)
+                self._dirty.setdefault(widget_id, set()).add(group)
+
+    def _record(self, w: PayloadUiWidget, groups: set) -> bytes:
+        return UiFieldUpdate(
+            w.widget_id,
+            value=w.value if "value" in groups else None,
+            flags=w.flags if "flags" in groups else None,
+            color=w.color if "color" in groups else None,
+            range=(w.min, w.max) if "range" in groups else None,
+            rect=(w.x, w.y, w.w, w.h) if "rect" in groups else None,
+            label=w.label if "label" in groups else None,
+        ).pack()
+
+    def frames(self, now_ms: int) -> List[bytes]:
+        """CMD_UI_UPDATE payloads for everything changed since the last call."""
+        if self._refreshed_ms is None:
+            self._refreshed_ms = now_ms
+        elif now_ms - self._refreshed_ms >= self.refresh_ms:
+            self._refreshed_ms = now_ms
+            for widget_id in self.widgets:
+                self._dirty.setdefault(widget_id, set()).update(_REFRESHED)
+
+        payloads: List[bytes] = []
+        records: List[bytes] = []
+        size = 1
+        for widget_id in sorted(self._dirty):
+            rec = self._record(self.widgets[widget_id], self._dirty[widget_id])
+            if size + len(rec) > HU_MAX_PAYLOAD_SIZE or len(records) == 0xFF:
+                payloads.append(ui_update(records))
+                records, size = [], 1
+            records.append(rec)
+            size += len(rec)
+        if records:
+            payloads.append(ui_update(records))
+        self._dirty.clear()
+        return payloads
+
+    def on_error(self, payload: bytes) -> List[bytes]:
+        """ERROR from the knob: the CMD_UI_WIDGET payloads to send again.
+
+        WIDGET_NOT_CACHED means the node lost its cache (reboot), so every
+        definition is re-sent, not only the one it named.
+        """
+        err = PayloadError.unpack(payload)
+        if (
+            err is None
+            or err.ref_msg_type != MsgType.CMD_UI_UPDATE
+            or err.code != ErrorCode.WIDGET_NOT_CACHED
+        ):
+            return []
+        self._dirty.clear()
+        return [w.pack() for _, w in sorted(self.widgets.items())]
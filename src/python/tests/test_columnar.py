@@ -0,0 +1,154 @@
+"""Columnar batch decode: same values as the per-payload unpackers, both paths.
+
+Run with `pytest -q` from the repository root (or
+`PYTHONPATH=src/python python -m unittest discover -s src/python/tests`).
+"""
+
+import struct
+import unittest
+from unittest import mock
+
+from cd_protocol import (
+    BLOCK_HAS_B,
+    MsgType,
+    PayloadDataBlock,
+    PayloadInputEvent,
+    PayloadScaleData,
+    columnar,
+)
+
+try:
+    import numpy
+except ImportError:  # pragma: no cover - optional dependency
+    numpy = None
+
+
+def wrap_i32(v: int) -> int:
+    return ((v + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+
+
+def varint(v: int) -> bytes:
+    z = (v << 1) ^ (v >> 63)
+    out = bytearray()
+    while True:
+        byte = z & 0x7F
+        z >>= 7
+        if z:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def block(source, channel, interval, samples, has_b=True, count=None) -> bytes:
+    """DATA_BLOCK payload for samples [(a, b), ...], base timestamp 1000."""
+    (a, b), rest = samples[0], samples[1:]
+    out = bytearray(
+        struct.pack(
+            "<BBBBHIiiB",
+            source,
+            channel,
+            BLOCK_HAS_B if has_b else 0,
+            len(samples) if count is None else count,
+            interval,
+            1000,
+            a,
+            b,
+            7,
+        )
+    )
+    for na, nb in rest:
+        out += varint(wrap_i32(na - a))
+        if has_b:
+            out += varint(wrap_i32(nb - b))
+        a, b = na, nb
+    return bytes(out)
+
+
+def expected_block_columns(payloads, source_type):
+    rows = []
+    for p in payloads:
+        blk = PayloadDataBlock.unpack(p)
+        if blk is None or blk.source_type != source_type:
+            continue
+        rows += [(blk.channel, t, a, b) for t, a, b in blk.samples]
+    return [list(col) for col in zip(*rows)] if rows else [[], [], [], []]
+
+
+class ColumnarTestMixin:
+    def setUp(self):
+        scale = MsgType.DATA_SCALE
+        multi = MsgType.DATA_MULTI
+        good = block(scale, 0, 100, [(5000, 10), (5200, 12), (4900, -3), (4900, 0)])
+        self.blocks = [
+            good,
+            block(scale, 1, 50, [(1, 0), (-(2**31), 0), (2**31 - 1, 0)], has_b=False),
+            block(scale, 2, 10, [(0, 0), (300, -300), (70000, 1)])[:-2],  # Truncated
+            good[:-1] + b"\x80\x80\x80\x80\x80",  # Over-long last varint
+            block(scale, 3, 10, [(42, 43)], count=0),
+            block(multi, 4, 10, [(1, 1), (2, 2)]),  # Other source_type
+            b"\x32\x00",  # Shorter than the header
+        ]
+        self.scale = [
+            struct.pack("<IihB", 1000 + i, -i * 1000, i - 50, i & 3) for i in range(100)
+        ]
+        self.inputs = [struct.pack("<BBi", i % 4, i % 3, -i) for i in range(50)]
+
+    def test_block_batch(self):
+        cols = columnar.decode_block_batch(self.blocks)
+        self.assertEqual(cols.skipped, 2)
+        expected = expected_block_columns(self.blocks, MsgType.DATA_SCALE)
+        got = [list(cols[n]) for n in ("channel", "timestamp_ms", "a", "b")]
+        self.assertEqual(got, expected)
+        self.assertEqual(len(cols), len(expected[0]))
+
+    def test_block_batch_other_source(self):
+        cols = columnar.decode_block_batch(self.blocks, MsgType.DATA_MULTI)
+        self.assertEqual(len(cols), 2)
+        self.assertEqual(list(cols.a), [1, 2])
+
+    def test_scale_batch(self):
+        cols = columnar.decode_scale_batch(self.scale + [b"\x00" * 3])
+        self.assertEqual(cols.skipped, 1)
+        rows = [PayloadScaleData.unpack(p) for p in self.scale]
+        self.assertEqual(list(cols.weight_mg), [r.weight_mg for r in rows])
+        self.assertEqual(list(cols.flow_mg_s), [r.flow_mg_s for r in rows])
+        self.assertEqual(list(cols.status), [r.status for r in rows])
+
+    def test_input_batch(self):
+        cols = columnar.decode_input_batch(self.inputs)
+        rows = [PayloadInputEvent.unpack(p) for p in self.inputs]
+        self.assertEqual(list(cols.value), [r.value for r in rows])
+        self.assertEqual(list(cols.event_type), [r.event_type for r in rows])
+
+    def test_empty(self):
+        self.assertEqual(len(columnar.decode_block_batch([])), 0)
+        self.assertEqual(len(columnar.decode_scale_batch([])), 0)
+
+
+class ArrayPathTest(ColumnarTestMixin, unittest.TestCase):
+    def setUp(self):
+        super().setUp()
+        patcher = mock.patch.object(columnar, "np", None)
+        patcher.start()
+        self.addCleanup(patcher.stop)
+
+    def test_columns_are_arrays(self):
+        cols = columnar.decode_block_batch(self.blocks)
+        self.assertEqual(cols.a.typecode, "i")
+        scale = columnar.decode_scale_batch(self.scale)
+        self.assertEqual(scale.weight_mg.typecode, "i")
+
+
+@unittest.skipIf(numpy is None, "NumPy not installed")
+class NumpyPathTest(ColumnarTestMixin, unittest.TestCase):
+    def test_columns_match_c_layout(self):
+        cols = columnar.decode_block_batch(self.blocks)
+        self.assertEqual(cols.a.dtype, numpy.dtype("<i4"))
+        self.assertEqual(cols.timestamp_ms.dtype, numpy.dtype("<u4"))
+        scale = columnar.decode_scale_batch(self.scale)
+        self.assertEqual(scale.weight_mg.dtype, numpy.dtype("<i4"))
+
+
+if __name__ == "__main__":
+    unittest.main()
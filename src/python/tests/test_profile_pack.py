@@ -0,0 +1,111 @@
+"""Profile node packing: byte-identical to the v0.2 packer on both paths.
+
+Run with `pytest -q` from the repository root (or
+`PYTHONPATH=src/python python -m unittest discover -s src/python/tests`).
+"""
+
+import struct
+import unittest
+from unittest import mock
+
+import cd_protocol
+from cd_protocol import PayloadProfileLoad, PayloadProfileNode, profile_hash
+
+try:
+    import numpy
+except ImportError:  # pragma: no cover - optional dependency
+    numpy = None
+
+
+def baseline_pack(n: PayloadProfileNode) -> bytes:
+    """PayloadProfileNode.pack() as shipped in v0.2."""
+    config = (n.interpolation & 0x03) | ((n.priority & 0x03) << 2)
+
+    def _s(val, factor):
+        i = int(round(val / factor))
+        return max(0, min(255, i))
+
+    return struct.pack(
+        "<HB BBBBBBBBBB",
+        n.time_offset_ms,
+        config,
+        _s(n.temp_target, 0.5),
+        _s(n.temp_tol, 0.5),
+        _s(n.press_target, 0.1),
+        _s(n.press_tol, 0.1),
+        _s(n.flow_in_target, 0.1),
+        _s(n.flow_in_tol, 0.1),
+        _s(n.flow_out_target, 0.1),
+        _s(n.flow_out_tol, 0.1),
+        _s(n.energy_target, 1),
+        _s(n.energy_tol, 1),
+    )
+
+
+def grid_nodes():
+    """Every 0.05 step on the 0.1 LSB fields, 0.25 on the 0.5 LSB fields,
+    out-of-range values on both sides (clamped)."""
+    nodes = []
+    for i in range(-4, 560):
+        t = i * 0.05
+        nodes.append(
+            PayloadProfileNode(
+                time_offset_ms=(i * 7) & 0xFFFF,
+                priority=i & 3,
+                interpolation=(i >> 2) & 3,
+                temp_target=i * 0.25,
+                temp_tol=t,
+                press_target=t,
+                press_tol=round(t, 2),
+                flow_in_target=t + 0.01,
+                flow_in_tol=t - 0.01,
+                flow_out_target=i * 0.15,
+                flow_out_tol=i * 0.35,
+                energy_target=i // 2,
+                energy_tol=i,
+            )
+        )
+    return nodes
+
+
+def pack_all(nodes) -> bytes:
+    out = bytearray()
+    for first in range(0, len(nodes), 17):
+        out += PayloadProfileLoad(0, nodes[first : first + 17]).pack()[2:]
+    return bytes(out)
+
+
+class ProfilePackTest(unittest.TestCase):
+    def setUp(self):
+        self.nodes = grid_nodes()
+        self.expected = b"".join(baseline_pack(n) for n in self.nodes)
+
+    def test_common_values(self):
+        for bar, raw in ((0.15, 1), (0.35, 3), (1.15, 11)):
+            node = PayloadProfileNode(0, 0, 0, 0, 0, bar, 0, 0, 0, 0, 0, 0, 0)
+            self.assertEqual(node.pack()[5], raw)
+
+    def test_node_pack_matches_baseline(self):
+        packed = b"".join(n.pack() for n in self.nodes)
+        self.assertEqual(packed, self.expected)
+
+    def test_struct_path_matches_baseline(self):
+        with mock.patch.object(cd_protocol, "np", None):
+            self.assertEqual(pack_all(self.nodes), self.expected)
+            self.assertEqual(profile_hash(self.nodes[:17]), self._baseline_hash())
+
+    @unittest.skipIf(numpy is None, "NumPy not installed")
+    def test_numpy_path_matches_baseline(self):
+        self.assertIsNotNone(cd_protocol.np)
+        self.assertEqual(pack_all(self.nodes), self.expected)
+        self.assertEqual(profile_hash(self.nodes[:17]), self._baseline_hash())
+
+    def _baseline_hash(self) -> int:
+        h = 2166136261
+        for b in self.expected[: 17 * 13]:
+            h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+        return h
+
+
+if __name__ == "__main__":
+    unittest.main()
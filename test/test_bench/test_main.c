@@ -0,0 +1,80 @@
+/**
+ * @file test_main.c
+ * @brief Runs hu_bench_run() and prints its BENCH lines
+ *
+ *     pio test -e esp32dev -f test_bench -v   // CPU cycles per op
+ *     pio test -e native -f test_bench -v     // ns per op on the host
+ */
+
+#include <stdint.h>
+#include <unity.h>
+
+#include "hu_bench.h"
+
+#ifdef ESP_PLATFORM
+#include "esp_cpu.h"
+#include "esp_idf_version.h"
+
+#define BENCH_SCALE 1
+
+static uint32_t bench_clock(void)
+{
+#if ESP_IDF_VERSION_MAJOR >= 5
+  return (uint32_t)esp_cpu_get_cycle_count();
+#else
+  return esp_cpu_get_ccount();
+#endif
+}
+#else
+#include <time.h>
+
+#define BENCH_SCALE 4
+
+static uint32_t bench_clock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void test_bench_run(void)
+{
+  hu_bench_result_t results[HU_BENCH_COUNT];
+  uint8_t n = hu_bench_run(bench_clock, BENCH_SCALE, results, HU_BENCH_COUNT);
+  TEST_ASSERT_EQUAL_UINT8(HU_BENCH_COUNT, n);
+  for (uint8_t i = 0; i < n; i++)
+  {
+    char line[80];
+    hu_bench_format(&results[i], line, sizeof(line));
+    TEST_MESSAGE(line);
+    TEST_ASSERT_NOT_EQUAL(0, results[i].iterations);
+  }
+}
+
+static int run_tests(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_bench_run);
+  return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void)
+{
+  run_tests();
+}
+#else
+int main(void)
+{
+  return run_tests();
+}
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file test_main.c
+ * @brief hu_profile_eval: extending a loaded profile matches a full load
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "hu_profile_eval.h"
+
+#define NODE_COUNT 6
+
+static hu_profile_node_t s_nodes[NODE_COUNT];
+static hu_profile_eval_t s_full;
+static hu_profile_eval_t s_part;
+
+static void set_node(uint8_t i, uint16_t t_ms, uint8_t press, uint8_t temp)
+{
+  hu_profile_node_t *n = &s_nodes[i];
+  memset(n, 0, sizeof(*n));
+  n->time_offset_ms = t_ms;
+  n->config_flags = HU_NODE_CONFIG(HU_INTERPOLATION_SPLINE, HU_PRIORITY_PRESSURE);
+  n->temp_target = temp;
+  n->temp_tol = 4;
+  n->press_target = press;
+  n->press_tol = (uint8_t)(2 + i);
+  n->flow_in_target = (uint8_t)(10 * i);
+}
+
+static void assert_same_at(uint32_t t_ms)
+{
+  hu_profile_setpoint_t a;
+  hu_profile_setpoint_t b;
+  hu_profile_eval_at(&s_full, t_ms, &a);
+  hu_profile_eval_at(&s_part, t_ms, &b);
+  TEST_ASSERT_EQUAL_MEMORY(&a, &b, sizeof(a));
+}
+
+void setUp(void)
+{
+  // Rising pressure, so every interior node has a non-zero tangent
+  set_node(0, 0, 20, 180);
+  set_node(1, 1000, 40, 184);
+  set_node(2, 2000, 70, 186);
+  set_node(3, 3500, 90, 187);
+  set_node(4, 5000, 95, 188);
+  set_node(5, 8000, 96, 188);
+  TEST_ASSERT_TRUE(hu_profile_eval_load(&s_full, s_nodes, NODE_COUNT));
+}
+
+void tearDown(void)
+{
+}
+
+// Cursor sits in segment old-2 with coefficients built while node old-1 was
+// still the last one (tangent 0)
+static void test_extend_mid_segment(void)
+{
+  TEST_ASSERT_TRUE(hu_profile_eval_load(&s_part, s_nodes, 3));
+  hu_profile_setpoint_t sp;
+  hu_profile_eval_at(&s_part, 1200, &sp);
+  TEST_ASSERT_EQUAL_UINT8(1, sp.segment);
+
+  TEST_ASSERT_TRUE(hu_profile_eval_extend(&s_part, NODE_COUNT));
+  TEST_ASSERT_EQUAL_MEMORY(s_full.inv_dt_q32, s_part.inv_dt_q32, sizeof(s_full.inv_dt_q32));
+  TEST_ASSERT_EQUAL_MEMORY(s_full.tangent_q16, s_part.tangent_q16, sizeof(s_full.tangent_q16));
+  for (uint32_t t = 1400; t <= 9000; t += 25)
+  {
+    assert_same_at(t);
+  }
+}
+
+// Cursor holds the old last node
+static void test_extend_in_last_segment(void)
+{
+  TEST_ASSERT_TRUE(hu_profile_eval_load(&s_part, s_nodes, 4));
+  for (uint32_t t = 0; t < 2000; t += 100)
+  {
+    assert_same_at(t); // Segments whose tangents the tail does not reach
+  }
+  hu_profile_setpoint_t sp;
+  hu_profile_eval_at(&s_part, 3550, &sp);
+  TEST_ASSERT_TRUE(sp.finished);
+
+  TEST_ASSERT_TRUE(hu_profile_eval_extend(&s_part, NODE_COUNT));
+  for (uint32_t t = 3600; t <= 9000; t += 25)
+  {
+    assert_same_at(t);
+  }
+}
+
+static void test_extend_rejects_backwards_time(void)
+{
+  TEST_ASSERT_TRUE(hu_profile_eval_load(&s_part, s_nodes, 3));
+  s_nodes[4].time_offset_ms = 3000; // Goes back from node 3
+  TEST_ASSERT_FALSE(hu_profile_eval_extend(&s_part, NODE_COUNT));
+  TEST_ASSERT_EQUAL_UINT8(3, s_part.count);
+
+  // Unchanged: still evaluates like a fresh 3-node load
+  TEST_ASSERT_TRUE(hu_profile_eval_load(&s_full, s_nodes, 3));
+  for (uint32_t t = 0; t <= 2500; t += 50)
+  {
+    assert_same_at(t);
+  }
+}
+
+static void test_extend_requires_load(void)
+{
+  TEST_ASSERT_FALSE(hu_profile_eval_load(&s_part, NULL, 3));
+  TEST_ASSERT_FALSE(hu_profile_eval_extend(&s_part, 3));
+  TEST_ASSERT_EQUAL_UINT8(0, s_part.count);
+}
+
+static int run_tests(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_extend_mid_segment);
+  RUN_TEST(test_extend_in_last_segment);
+  RUN_TEST(test_extend_rejects_backwards_time);
+  RUN_TEST(test_extend_requires_load);
+  return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void)
+{
+  run_tests();
+}
+#else
+int main(void)
+{
+  return run_tests();
+}
+#endif
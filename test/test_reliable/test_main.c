@@ -0,0 +1,154 @@
+/**
+ * @file test_main.c
+ * @brief hu_reliable: delivery, duplicates and stream restarts
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "hu_reliable.h"
+
+typedef struct
+{
+  uint8_t frames[16][HU_MAX_FRAME_SIZE];
+  uint16_t lens[16];
+  uint8_t count;
+} wire_t;
+
+static wire_t s_wire;
+static hu_rel_tx_t s_tx;
+static hu_rel_rx_t s_rx;
+
+static bool capture(const uint8_t *frame, uint16_t len, void *ctx)
+{
+  wire_t *w = (wire_t *)ctx;
+  if (w->count < 16)
+  {
+    memcpy(w->frames[w->count], frame, len);
+    w->lens[w->count++] = len;
+  }
+  return true;
+}
+
+static void send_one(uint8_t msg_type)
+{
+  uint8_t frame[HU_FRAME_HEADER_SIZE] = {0};
+  hu_frame_header_t *hdr = (hu_frame_header_t *)(void *)frame;
+  hdr->magic = HU_PROTOCOL_MAGIC;
+  hdr->msg_type = msg_type;
+  TEST_ASSERT_EQUAL(HU_REL_OK, hu_rel_tx_send(&s_tx, frame, sizeof(frame), 0));
+}
+
+// Delivers wire frame i to the receiver and its ACK back to the sender
+static bool deliver(uint8_t i)
+{
+  hu_payload_ack_t ack;
+  bool is_new = hu_rel_rx_on_frame(&s_rx, (const hu_frame_header_t *)(const void *)s_wire.frames[i], &ack);
+  hu_rel_tx_on_ack(&s_tx, &ack, 1);
+  return is_new;
+}
+
+void setUp(void)
+{
+  memset(&s_wire, 0, sizeof(s_wire));
+  hu_rel_tx_init(&s_tx, capture, &s_wire);
+  hu_rel_rx_init(&s_rx);
+}
+
+void tearDown(void)
+{
+}
+
+static void test_in_order_and_duplicate(void)
+{
+  send_one(1);
+  send_one(2);
+  TEST_ASSERT_TRUE(deliver(0));
+  TEST_ASSERT_TRUE(deliver(1));
+  TEST_ASSERT_FALSE(deliver(1)); // Retransmission after a lost ACK
+  TEST_ASSERT_TRUE(hu_rel_tx_idle(&s_tx));
+  TEST_ASSERT_EQUAL_UINT16(2, s_rx.expected);
+}
+
+// Sender restarts while the receiver still expects a seq inside the first
+// window: the new SYN frames reuse seq 0.. and must not be taken as
+// duplicates of the old stream.
+static void test_restart_with_small_expected(void)
+{
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    send_one(i);
+    TEST_ASSERT_TRUE(deliver(i));
+  }
+  TEST_ASSERT_EQUAL_UINT16(3, s_rx.expected);
+
+  hu_rel_tx_reset(&s_tx);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    send_one((uint8_t)(10 + i));
+  }
+  for (uint8_t i = 3; i < 6; i++)
+  {
+    const hu_frame_header_t *hdr = (const hu_frame_header_t *)(const void *)s_wire.frames[i];
+    TEST_ASSERT_TRUE((hdr->flags & HU_FLAG_SYN) != 0);
+    TEST_ASSERT_EQUAL_UINT16(i - 3, hdr->seq_num);
+    TEST_ASSERT_TRUE(deliver(i));
+    TEST_ASSERT_EQUAL_UINT16(i - 2, s_tx.base); // Freed only once received
+  }
+  TEST_ASSERT_TRUE(hu_rel_tx_idle(&s_tx));
+}
+
+// Restarted sender whose first new frame is lost: the out-of-order SYN frame
+// is held until the hole is filled.
+static void test_restart_first_frame_lost(void)
+{
+  send_one(1);
+  TEST_ASSERT_TRUE(deliver(0));
+  hu_rel_tx_reset(&s_tx);
+  send_one(2);
+  send_one(3);
+  TEST_ASSERT_TRUE(deliver(2)); // seq 1 of the new stream
+  TEST_ASSERT_EQUAL_UINT16(0, s_rx.expected);
+  TEST_ASSERT_TRUE(deliver(1)); // seq 0
+  TEST_ASSERT_EQUAL_UINT16(2, s_rx.expected);
+  TEST_ASSERT_TRUE(hu_rel_tx_idle(&s_tx));
+}
+
+// Receiver rebooted mid-stream: the first frame it sees resyncs it.
+static void test_receiver_restart(void)
+{
+  for (uint8_t i = 0; i < 10; i++)
+  {
+    send_one(i);
+    if (i < 9)
+    {
+      TEST_ASSERT_TRUE(deliver(i));
+    }
+  }
+  hu_rel_rx_init(&s_rx);
+  TEST_ASSERT_TRUE(deliver(9));
+  TEST_ASSERT_EQUAL_UINT16(10, s_rx.expected);
+  TEST_ASSERT_TRUE(hu_rel_tx_idle(&s_tx));
+}
+
+static int run_tests(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_in_order_and_duplicate);
+  RUN_TEST(test_restart_with_small_expected);
+  RUN_TEST(test_restart_first_frame_lost);
+  RUN_TEST(test_receiver_restart);
+  return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void)
+{
+  run_tests();
+}
+#else
+int main(void)
+{
+  return run_tests();
+}
+#endif